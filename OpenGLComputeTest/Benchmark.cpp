@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+
+void Benchmark::addConfig(const std::string& name, std::function<void()> apply)
+{
+	m_configs.push_back({ name, apply, {} });
+}
+
+void Benchmark::start()
+{
+	m_running = !m_configs.empty();
+	m_current = 0;
+	m_frame = 0;
+	for (Config& config : m_configs)
+		config.metrics.clear();
+}
+
+bool Benchmark::beginFrame()
+{
+	if (!m_running)
+		return false;
+
+	if (m_frame == m_warmupFrames + m_measuredFrames)
+	{
+		m_frame = 0;
+		if (++m_current == (int)m_configs.size())
+		{
+			m_running = false;
+			printResults();
+			return false;
+		}
+	}
+
+	if (m_frame == 0)
+	{
+		printf("Benchmarking '%s'...\n", m_configs[m_current].name.c_str());
+		m_configs[m_current].apply();
+	}
+
+	++m_frame;
+	return true;
+}
+
+void Benchmark::record(const std::string& metric, float value)
+{
+	if (!m_running || m_frame <= m_warmupFrames)
+		return;
+
+	if (std::find(m_metricOrder.begin(), m_metricOrder.end(), metric) == m_metricOrder.end())
+		m_metricOrder.push_back(metric);
+
+	std::pair<double, int>& sum = m_configs[m_current].metrics[metric];
+	sum.first += value;
+	++sum.second;
+}
+
+void Benchmark::printResults() const
+{
+	printf("\n%-32s", "Configuration");
+	for (const std::string& metric : m_metricOrder)
+		printf(" %20s", metric.c_str());
+	printf("\n");
+
+	for (const Config& config : m_configs)
+	{
+		printf("%-32s", config.name.c_str());
+		for (const std::string& metric : m_metricOrder)
+		{
+			auto it = config.metrics.find(metric);
+			if (it != config.metrics.end() && it->second.second > 0)
+				printf(" %20.4f", it->second.first / it->second.second);
+			else
+				printf(" %20s", "-");
+		}
+		printf("\n");
+	}
+	printf("\n");
+}
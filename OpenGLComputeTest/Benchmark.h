@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Runs a list of named configurations one after another for a fixed number of frames each, averaging
+// whatever metrics are recorded (GPU pass times, steps per pixel, ...) after a warm-up period, then
+// prints a table of the results.
+class Benchmark
+{
+public:
+	Benchmark(int warmupFrames = 30, int measuredFrames = 120)
+		: m_warmupFrames(warmupFrames), m_measuredFrames(measuredFrames) {};
+
+	// 'apply' is called once when the configuration starts, to set the globals it benchmarks:
+	void addConfig(const std::string& name, std::function<void()> apply);
+
+	bool isRunning() const { return m_running; }
+	void start();
+
+	// Call once at the start of each frame. Returns false once every configuration has run:
+	bool beginFrame();
+
+	// Accumulate a metric for the current configuration (ignored during warm-up):
+	void record(const std::string& metric, float value);
+
+	void printResults() const;
+
+private:
+	struct Config
+	{
+		std::string name;
+		std::function<void()> apply;
+		std::map<std::string, std::pair<double, int>> metrics;	// Sum and sample count.
+	};
+
+	std::vector<Config> m_configs;
+	std::vector<std::string> m_metricOrder;
+	int m_warmupFrames;
+	int m_measuredFrames;
+	int m_current{};
+	int m_frame{};
+	bool m_running = false;
+};
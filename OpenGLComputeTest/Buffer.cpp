@@ -0,0 +1,110 @@
+#include "Buffer.h"
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	const GLbitfield PERSISTENT_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	GLenum getUsageHint(Buffer::Usage usage)
+	{
+		switch (usage)
+		{
+			case Buffer::Usage::STATIC:		return GL_STATIC_DRAW;
+			case Buffer::Usage::DYNAMIC:	return GL_DYNAMIC_DRAW;
+			default:						return GL_STREAM_DRAW;
+		}
+	}
+}
+
+void Buffer::init(GLenum target, GLsizeiptr size, const void* data, Usage usage)
+{
+	m_target = target;
+	m_size = size;
+	m_usage = usage;
+	m_mapped = nullptr;
+
+	if (!GLDsa::isAvailable())
+	{
+		// Filled through the copy target, so the buffer's own target keeps its binding:
+		m_handle = BufferHandle::create();
+		m_handle.bind(GL_COPY_WRITE_BUFFER);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, data, getUsageHint(usage));
+		return;
+	}
+
+	GLuint name;
+	GLDsa::createBuffers(1, &name);
+	m_handle = BufferHandle(name);
+	switch (usage)
+	{
+		case Usage::STATIC:
+			GLDsa::namedBufferStorage(name, size, data, 0);
+			break;
+		case Usage::DYNAMIC:
+			GLDsa::namedBufferStorage(name, size, data, GL_DYNAMIC_STORAGE_BIT);
+			break;
+		case Usage::STREAM:
+			GLDsa::namedBufferData(name, size, data, GL_STREAM_DRAW);
+			break;
+		case Usage::PERSISTENT:
+			GLDsa::namedBufferStorage(name, size, data, PERSISTENT_FLAGS);
+			m_mapped = GLDsa::mapNamedBufferRange(name, 0, size, PERSISTENT_FLAGS);
+			break;
+	}
+}
+
+void Buffer::update(GLintptr offset, GLsizeiptr size, const void* data)
+{
+	if (offset < 0 || size < 0 || offset + size > m_size)
+	{
+		std::cout << "ERROR::BUFFER: Update of " << size << " bytes at " << offset << " overruns a " << m_size << " byte buffer" << std::endl;
+		return;
+	}
+	if (m_usage == Usage::STATIC)
+	{
+		std::cout << "ERROR::BUFFER: Static buffers can't be updated" << std::endl;
+		return;
+	}
+	if (size == 0)
+		return;
+
+	if (m_mapped)
+	{
+		memcpy((char*)m_mapped + offset, data, size);
+		return;
+	}
+
+	// Streamed (and, without DSA, persistent) buffers never wait on draws still reading the old contents.
+	// A whole update orphans the storage for a fresh block, a partial one invalidates just its range:
+	const bool stream = m_usage == Usage::STREAM || m_usage == Usage::PERSISTENT;
+	const bool whole = offset == 0 && size == m_size;
+	if (GLDsa::isAvailable())
+	{
+		if (stream && whole)
+			GLDsa::namedBufferData(m_handle, m_size, NULL, GL_STREAM_DRAW);
+		if (stream && !whole)
+		{
+			void* range = GLDsa::mapNamedBufferRange(m_handle, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+			if (range)
+				memcpy(range, data, size);
+			GLDsa::unmapNamedBuffer(m_handle);
+		}
+		else
+			GLDsa::namedBufferSubData(m_handle, offset, size, data);
+		return;
+	}
+
+	m_handle.bind(GL_COPY_WRITE_BUFFER);
+	if (stream && whole)
+		glBufferData(GL_COPY_WRITE_BUFFER, m_size, NULL, getUsageHint(m_usage));
+	if (stream && !whole)
+	{
+		void* range = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+		if (range)
+			memcpy(range, data, size);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+	else
+		glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "GLDsa.h"
+#include <span>
+
+// GL buffer sized in whole elements from a span, with the storage picked for how often it changes. With
+// DSA, STATIC, DYNAMIC and PERSISTENT get immutable glBufferStorage; without it every usage falls back to
+// mutable glBufferData with the matching hint.
+class Buffer
+{
+public:
+	enum class Usage
+	{
+		STATIC,		// Never updated.
+		DYNAMIC,	// Updated now and then, in place.
+		STREAM,		// Rewritten every frame: whole updates orphan the storage, partial ones invalidate their range.
+		PERSISTENT	// Mapped for as long as it lives, updates are copies into the map. Callers keep clear of
+					// ranges the GPU is still reading.
+	};
+
+	Buffer() {};
+
+	void init(GLenum target, GLsizeiptr size, const void* data, Usage usage);
+
+	template <typename T>
+	void init(GLenum target, std::span<const T> data, Usage usage)
+	{
+		init(target, (GLsizeiptr)data.size_bytes(), data.data(), usage);
+	}
+
+	// Room for 'count' elements, left undefined:
+	template <typename T>
+	void allocate(GLenum target, size_t count, Usage usage)
+	{
+		init(target, (GLsizeiptr)(count * sizeof(T)), nullptr, usage);
+	}
+
+	void update(GLintptr offset, GLsizeiptr size, const void* data);
+
+	// Overwrite the elements from 'first' on:
+	template <typename T>
+	void update(std::span<const T> data, size_t first = 0)
+	{
+		update((GLintptr)(first * sizeof(T)), (GLsizeiptr)data.size_bytes(), data.data());
+	}
+
+	void bind() const								{ m_handle.bind(m_target); }
+	void bindBase(GLuint index) const				{ GLState::bindBufferBase(m_target, index, m_handle); }
+
+	GLuint get() const								{ return m_handle; }
+	GLsizeiptr getSize() const						{ return m_size; }
+	Usage getUsage() const							{ return m_usage; }
+	void* getMapped() const							{ return m_mapped; }
+
+private:
+	BufferHandle m_handle;
+	GLenum m_target{};
+	GLsizeiptr m_size{};
+	Usage m_usage{};
+	void* m_mapped{};	// Persistent buffers only.
+};
@@ -0,0 +1,64 @@
+#include "CheckerboardResolve.h"
+
+void CheckerboardResolve::init(int maxWidth, int maxHeight)
+{
+	m_shader.loadShader("res/raymarchResolveShader.comp");
+
+	// Colour is filtered when reprojected, depth is only compared:
+	m_historyColour = TextureHandle::create();
+	GLState::bindTexture(GL_TEXTURE_2D, m_historyColour);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, maxWidth, maxHeight);
+
+	m_historyDepth = TextureHandle::create();
+	GLState::bindTexture(GL_TEXTURE_2D, m_historyDepth);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32F, maxWidth, maxHeight);
+	GLState::bindTexture(GL_TEXTURE_2D, 0);
+}
+
+void CheckerboardResolve::resolve(unsigned int colourTex, unsigned int depthTex, int width, int height, const glm::vec3& cameraPos, int parity, float depthTolerance)
+{
+	// Reprojection assumes the history was rendered at the same resolution:
+	if (width != m_width || height != m_height)
+		m_historyValid = false;
+	m_width = width;
+	m_height = height;
+
+	m_shader.use();
+	m_shader.setInt("u_historyColour", 0);
+	m_shader.setInt("u_historyDepth", 1);
+	m_shader.setVec3("u_cameraPos", cameraPos);
+	m_shader.setVec3("u_prevCameraPos", m_prevCameraPos);
+	m_shader.setInt("u_checkerParity", parity);
+	m_shader.setBool("u_historyValid", m_historyValid);
+	m_shader.setFloat("u_depthTolerance", depthTolerance);
+	m_shader.setIVec2("u_frameSize", glm::ivec2(width, height));
+
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, m_historyColour);
+	GLState::activeTexture(GL_TEXTURE1);
+	GLState::bindTexture(GL_TEXTURE_2D, m_historyDepth);
+	GLState::activeTexture(GL_TEXTURE0);
+
+	GLState::bindImageTexture(0, colourTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+	GLState::bindImageTexture(3, depthTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32F);
+
+	// Traced pixels were just written through the same images:
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glDispatchCompute((m_width + 15) / 16, (m_height + 15) / 16, 1);
+
+	// The resolved frame is next frame's history:
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glCopyImageSubData(colourTex, GL_TEXTURE_2D, 0, 0, 0, 0, m_historyColour, GL_TEXTURE_2D, 0, 0, 0, 0, m_width, m_height, 1);
+	glCopyImageSubData(depthTex, GL_TEXTURE_2D, 0, 0, 0, 0, m_historyDepth, GL_TEXTURE_2D, 0, 0, 0, 0, m_width, m_height, 1);
+
+	m_prevCameraPos = cameraPos;
+	m_historyValid = true;
+}
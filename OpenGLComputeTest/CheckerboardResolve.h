@@ -0,0 +1,31 @@
+#pragma once
+#include "Shader.h"
+
+// Temporal reprojection for the checkerboard raymarch. The raymarcher traces half the pixels each frame
+// (alternating parity) and writes colour and hit depth; resolve() fills in the other half from the
+// previous frame's image, rejecting disoccluded samples by depth, then keeps the result as the history
+// for the next frame.
+class CheckerboardResolve
+{
+public:
+	CheckerboardResolve() {};
+
+	// History is allocated at the largest size that will be resolved:
+	void init(int maxWidth, int maxHeight);
+
+	// Resolve the skipped pixels in the width x height region at the origin of 'colourTex' (RGBA32F) and
+	// 'depthTex' (R32F), in place. The history is dropped if the size differs from the last resolve:
+	void resolve(unsigned int colourTex, unsigned int depthTex, int width, int height, const glm::vec3& cameraPos, int parity, float depthTolerance);
+
+	// Drop the history, e.g. after the scene changes. The next resolve interpolates spatially:
+	void invalidate() { m_historyValid = false; }
+
+private:
+	Shader m_shader;
+	TextureHandle m_historyColour;
+	TextureHandle m_historyDepth;
+	int m_width{}, m_height{};		// Of the last resolve.
+
+	glm::vec3 m_prevCameraPos{};
+	bool m_historyValid = false;
+};
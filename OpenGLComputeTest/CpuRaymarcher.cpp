@@ -0,0 +1,371 @@
+#include "CpuRaymarcher.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	// Same constants as raymarchComputeShader.comp:
+	const float MAX_DIST	= 50.0f;
+	const float MIN_DIST	= 0.01f;
+
+	const int TILE_SIZE		= 32;
+
+	// Scalar distance functions, kept branch-free so the per-lane loops below vectorise:
+	inline float length3(float x, float y, float z)
+	{
+		return sqrtf(x * x + y * y + z * z);
+	}
+
+	inline float polySmoothMin(float a, float b, float k)
+	{
+		float h = std::max(k - fabsf(a - b), 0.0f) / k;
+		return std::min(a, b) - h * h * k * (1.0f / 4.0f);
+	}
+
+	inline float smoothMinOrMin(float a, float b, float k)
+	{
+		return k > 0.0f ? polySmoothMin(a, b, k) : std::min(a, b);
+	}
+
+	template <int N>
+	struct Vec3Packet
+	{
+		alignas(64) float x[N];
+		alignas(64) float y[N];
+		alignas(64) float z[N];
+	};
+
+	// Distance to one primitive for every lane. The type switch is outside the lane loops, so each loop
+	// is a straight run of arithmetic:
+	template <int N>
+	void primitiveDistPacket(const SdfPrimitive& prim, const Vec3Packet<N>& pos, float* out)
+	{
+		const glm::mat4& m = prim.worldToLocal;
+		const glm::vec4& params = prim.params;
+
+		Vec3Packet<N> p;
+		for (int i = 0; i < N; ++i)
+		{
+			p.x[i] = m[0][0] * pos.x[i] + m[1][0] * pos.y[i] + m[2][0] * pos.z[i] + m[3][0];
+			p.y[i] = m[0][1] * pos.x[i] + m[1][1] * pos.y[i] + m[2][1] * pos.z[i] + m[3][1];
+			p.z[i] = m[0][2] * pos.x[i] + m[1][2] * pos.y[i] + m[2][2] * pos.z[i] + m[3][2];
+		}
+
+		switch ((SdfScene::Type)prim.type)
+		{
+			case SdfScene::Type::SPHERE:
+				for (int i = 0; i < N; ++i)
+					out[i] = length3(p.x[i], p.y[i], p.z[i]) - params.x;
+				break;
+			case SdfScene::Type::BOX:
+				for (int i = 0; i < N; ++i)
+				{
+					float qx = fabsf(p.x[i]) - params.x;
+					float qy = fabsf(p.y[i]) - params.y;
+					float qz = fabsf(p.z[i]) - params.z;
+					out[i] = length3(std::max(qx, 0.0f), std::max(qy, 0.0f), std::max(qz, 0.0f)) + std::min(std::max(qx, std::max(qy, qz)), 0.0f);
+				}
+				break;
+			case SdfScene::Type::TORUS:
+				for (int i = 0; i < N; ++i)
+				{
+					float qx = sqrtf(p.x[i] * p.x[i] + p.z[i] * p.z[i]) - params.x;
+					out[i] = sqrtf(qx * qx + p.y[i] * p.y[i]) - params.y;
+				}
+				break;
+			case SdfScene::Type::PLANE:
+				for (int i = 0; i < N; ++i)
+					out[i] = p.y[i];
+				break;
+			case SdfScene::Type::CAPSULE:
+				for (int i = 0; i < N; ++i)
+				{
+					float y = p.y[i] - glm::clamp(p.y[i], -params.x, params.x);
+					out[i] = length3(p.x[i], y, p.z[i]) - params.y;
+				}
+				break;
+		}
+
+		for (int i = 0; i < N; ++i)
+			out[i] *= prim.scale;
+	}
+
+	// Fold every primitive into the scene distance in order, as GetDistFull() does in the shader:
+	template <int N>
+	void sceneDistPacket(const RaymarchParams& s, const Vec3Packet<N>& p, float* out)
+	{
+		alignas(64) float primDist[N];
+		for (int i = 0; i < N; ++i)
+			out[i] = MAX_DIST;
+
+		for (const SdfPrimitive& prim : s.primitives)
+		{
+			primitiveDistPacket<N>(prim, p, primDist);
+
+			// Bounding-sphere early-outs, selected rather than branched on so lanes stay in step:
+			if (s.useBounds && prim.bounds.w >= 0.0f)
+			{
+				const float margin = prim.blendK + MIN_DIST;
+				for (int i = 0; i < N; ++i)
+				{
+					float bound = length3(p.x[i] - prim.bounds.x, p.y[i] - prim.bounds.y, p.z[i] - prim.bounds.z) - prim.bounds.w;
+					primDist[i] = bound > margin ? bound : primDist[i];
+				}
+			}
+
+			const float k = prim.blendK;
+			switch ((SdfScene::Op)prim.op)
+			{
+				case SdfScene::Op::UNION:
+					for (int i = 0; i < N; ++i)
+						out[i] = smoothMinOrMin(out[i], primDist[i], k);
+					break;
+				case SdfScene::Op::SUBTRACT:
+					for (int i = 0; i < N; ++i)
+						out[i] = -smoothMinOrMin(-out[i], primDist[i], k);
+					break;
+				case SdfScene::Op::INTERSECT:
+					for (int i = 0; i < N; ++i)
+						out[i] = -smoothMinOrMin(-out[i], -primDist[i], k);
+					break;
+			}
+		}
+	}
+
+	inline float getEpsilon(const RaymarchParams& s, float dO)
+	{
+		return s.relativeEpsilon ? s.epsilon * std::max(dO, 1.0f) : s.epsilon;
+	}
+
+	// Sphere-trace every lane up to tMax, masking out lanes once they hit or pass it. Inactive lanes are
+	// still evaluated (as SIMD hardware would) but no longer advance. Over-relaxation and its fallback
+	// follow RayMarch() in the shader step for step:
+	template <int N>
+	void rayMarchPacket(const RaymarchParams& s, const Vec3Packet<N>& ro, const Vec3Packet<N>& rd, const float* tMax, float* dO, int* steps)
+	{
+		Vec3Packet<N> p;
+		alignas(64) float dS[N];
+		alignas(64) float omega[N];
+		alignas(64) float prevDist[N];
+		alignas(64) float stepLength[N];
+		bool active[N];
+
+		for (int i = 0; i < N; ++i)
+		{
+			dO[i] = 0.0f;
+			omega[i] = s.relaxation;
+			prevDist[i] = 0.0f;
+			stepLength[i] = 0.0f;
+			active[i] = true;
+		}
+
+		for (int step = 0; step < s.maxSteps; ++step)
+		{
+			for (int i = 0; i < N; ++i)
+			{
+				p.x[i] = ro.x[i] + rd.x[i] * dO[i];
+				p.y[i] = ro.y[i] + rd.y[i] * dO[i];
+				p.z[i] = ro.z[i] + rd.z[i] * dO[i];
+			}
+			sceneDistPacket<N>(s, p, dS);
+
+			// Both outcomes of each lane's step are computed and the right one selected, so the loop has no
+			// branches and vectorises. Inactive lanes go through it too but keep their state:
+			int activeCount = 0;
+			for (int i = 0; i < N; ++i)
+			{
+				const bool live = active[i];
+
+				// Relaxed step overshot, go back to the plain step:
+				const bool overshot = omega[i] > 1.0f && dS[i] + prevDist[i] < stepLength[i];
+				const float advanced = dO[i] + dS[i];
+				const bool done = !overshot && (advanced > tMax[i] || dS[i] < getEpsilon(s, advanced));
+				const float next = overshot ? dO[i] + (prevDist[i] - stepLength[i])
+					: done ? advanced : advanced + dS[i] * (omega[i] - 1.0f);
+
+				dO[i] = live ? next : dO[i];
+				stepLength[i] = live && !done ? (overshot ? prevDist[i] : dS[i] * omega[i]) : stepLength[i];
+				prevDist[i] = live && !overshot && !done ? dS[i] : prevDist[i];
+				omega[i] = live && overshot ? 1.0f : omega[i];
+				steps[i] += live ? 1 : 0;
+				activeCount += live ? 1 : 0;
+				active[i] = live && !done;
+			}
+
+			// Early exit once every lane is done:
+			if (activeCount == 0)
+				break;
+		}
+	}
+
+	template <int N>
+	void getNormalPacket(const RaymarchParams& s, const Vec3Packet<N>& p, Vec3Packet<N>& n)
+	{
+		const float e = 0.01f;
+		alignas(64) float d[N], dx[N], dy[N], dz[N];
+		Vec3Packet<N> q = p;
+
+		sceneDistPacket<N>(s, p, d);
+		for (int i = 0; i < N; ++i) q.x[i] = p.x[i] - e;
+		sceneDistPacket<N>(s, q, dx);
+		q = p;
+		for (int i = 0; i < N; ++i) q.y[i] = p.y[i] - e;
+		sceneDistPacket<N>(s, q, dy);
+		q = p;
+		for (int i = 0; i < N; ++i) q.z[i] = p.z[i] - e;
+		sceneDistPacket<N>(s, q, dz);
+
+		for (int i = 0; i < N; ++i)
+		{
+			float nx = d[i] - dx[i], ny = d[i] - dy[i], nz = d[i] - dz[i];
+			float invLen = 1.0f / length3(nx, ny, nz);
+			n.x[i] = nx * invLen;
+			n.y[i] = ny * invLen;
+			n.z[i] = nz * invLen;
+		}
+	}
+
+	// Trace one packet of N horizontally adjacent pixels starting at (x0, y), returning the total steps
+	// taken by the packet's pixels:
+	template <int N>
+	int tracePacket(const RaymarchParams& s, int x0, int y, int width, int height, std::vector<glm::vec4>& pixels)
+	{
+		Vec3Packet<N> ro, rd, p, n, shadowRo, l;
+		alignas(64) float d[N], shadowD[N], diff[N], lightDist[N], maxDist[N];
+		int steps[N] = {};
+
+		const glm::vec3 lightPos = glm::vec3(2.0f * sinf(s.time), 5.0f, 6.0f - 2.0f * cosf(s.time));
+
+		// Primary rays, with UVs normalised the same way as the shader:
+		for (int i = 0; i < N; ++i)
+		{
+			float u = ((float)std::min(x0 + i, width - 1) - width * 0.5f) / (float)height;
+			float v = ((float)y - height * 0.5f) / (float)height;
+			float invLen = 1.0f / length3(u, v, 1.0f);
+
+			ro.x[i] = s.cameraPos.x;
+			ro.y[i] = s.cameraPos.y;
+			ro.z[i] = s.cameraPos.z;
+			rd.x[i] = u * invLen;
+			rd.y[i] = v * invLen;
+			rd.z[i] = invLen;
+			maxDist[i] = MAX_DIST;
+		}
+		rayMarchPacket<N>(s, ro, rd, maxDist, d, steps);
+
+		for (int i = 0; i < N; ++i)
+		{
+			p.x[i] = ro.x[i] + rd.x[i] * d[i];
+			p.y[i] = ro.y[i] + rd.y[i] * d[i];
+			p.z[i] = ro.z[i] + rd.z[i] * d[i];
+		}
+		getNormalPacket<N>(s, p, n);
+
+		// Diffuse term and shadow rays towards the light:
+		for (int i = 0; i < N; ++i)
+		{
+			float lx = lightPos.x - p.x[i], ly = lightPos.y - p.y[i], lz = lightPos.z - p.z[i];
+			lightDist[i] = length3(lx, ly, lz);
+			l.x[i] = lx / lightDist[i];
+			l.y[i] = ly / lightDist[i];
+			l.z[i] = lz / lightDist[i];
+
+			diff[i] = glm::clamp(l.x[i] * n.x[i] + l.y[i] * n.y[i] + l.z[i] * n.z[i], 0.0f, 1.0f);
+
+			shadowRo.x[i] = p.x[i] + n.x[i] * (MIN_DIST * 2.0f);
+			shadowRo.y[i] = p.y[i] + n.y[i] * (MIN_DIST * 2.0f);
+			shadowRo.z[i] = p.z[i] + n.z[i] * (MIN_DIST * 2.0f);
+		}
+		// Shadow rays stop at the light, nothing past it matters:
+		rayMarchPacket<N>(s, shadowRo, l, lightDist, shadowD, steps);
+
+		int totalSteps = 0;
+		for (int i = 0; i < N && x0 + i < width; ++i)
+		{
+			totalSteps += steps[i];
+
+			if (shadowD[i] < lightDist[i])
+				diff[i] *= 0.25f;
+
+			glm::vec3 col = (glm::vec3(n.x[i], n.y[i], n.z[i]) * 0.5f + 0.5f) * diff[i];
+			col = glm::pow(col, glm::vec3(0.4545f));
+			pixels[y * width + x0 + i] = glm::vec4(col, 1.0f);
+		}
+		return totalSteps;
+	}
+
+	template <int N>
+	long long renderTile(const RaymarchParams& s, int tileX, int tileY, int width, int height, std::vector<glm::vec4>& pixels)
+	{
+		const int xEnd = std::min(tileX + TILE_SIZE, width);
+		const int yEnd = std::min(tileY + TILE_SIZE, height);
+
+		long long steps = 0;
+		for (int y = tileY; y < yEnd; ++y)
+			for (int x = tileX; x < xEnd; x += N)
+				steps += tracePacket<N>(s, x, y, width, height, pixels);
+		return steps;
+	}
+}
+
+void CpuRaymarcher::render(const RaymarchParams& params, int width, int height, int packetWidth, std::vector<glm::vec4>& pixels)
+{
+	pixels.resize((size_t)width * height);
+
+	const int tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	const int tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	std::atomic<long long> totalSteps{};
+
+	m_pool.parallelFor(tilesX * tilesY, [&](int tile)
+	{
+		const int tileX = (tile % tilesX) * TILE_SIZE;
+		const int tileY = (tile / tilesX) * TILE_SIZE;
+
+		if (packetWidth == 16)
+			totalSteps += renderTile<16>(params, tileX, tileY, width, height, pixels);
+		else
+			totalSteps += renderTile<8>(params, tileX, tileY, width, height, pixels);
+	});
+
+	m_averageSteps = (float)((double)totalSteps / ((double)width * height));
+}
+
+void CpuRaymarcher::compare(const std::vector<glm::vec4>& a, const std::vector<glm::vec4>& b, float& rmse, float& maxError)
+{
+	double sumSqr = 0.0;
+	maxError = 0.0f;
+
+	const size_t count = std::min(a.size(), b.size());
+	for (size_t i = 0; i < count; ++i)
+	{
+		glm::vec3 diff = glm::abs(glm::vec3(a[i]) - glm::vec3(b[i]));
+		sumSqr += (double)glm::dot(diff, diff);
+		maxError = std::max(maxError, std::max(diff.x, std::max(diff.y, diff.z)));
+	}
+	rmse = count > 0 ? (float)sqrt(sumSqr / (count * 3.0)) : 0.0f;
+}
+
+bool CpuRaymarcher::writePPM(const char* path, const std::vector<glm::vec4>& pixels, int width, int height)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+
+	// PPM is stored top row first:
+	std::vector<unsigned char> row((size_t)width * 3);
+	for (int y = height - 1; y >= 0; --y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const glm::vec4& c = pixels[(size_t)y * width + x];
+			for (int i = 0; i < 3; ++i)
+				row[x * 3 + i] = (unsigned char)(glm::clamp(c[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+		file.write((const char*)row.data(), row.size());
+	}
+	return (bool)file;
+}
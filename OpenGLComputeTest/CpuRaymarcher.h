@@ -0,0 +1,47 @@
+#pragma once
+#include "ThreadPool.h"
+#include "SdfScene.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// Scene and camera parameters, matching the uniforms of raymarchComputeShader.comp:
+struct RaymarchParams
+{
+	std::vector<SdfPrimitive> primitives;
+	glm::vec3 cameraPos;
+	float time;				// Drives the light's orbit.
+
+	// Step and epsilon policy (defaults are plain sphere tracing):
+	int maxSteps		= 100;
+	float relaxation	= 1.0f;		// Over-relaxation factor, in [1, 2).
+	float epsilon		= 0.01f;
+	bool relativeEpsilon = false;	// Scale epsilon by distance along the ray.
+	bool useBounds		= false;	// Bounding-sphere early-outs for bounded primitives.
+};
+
+// CPU mirror of raymarchComputeShader.comp, used as a golden reference for the GPU image and for
+// previews on machines without a GPU. Rays are traced in packets of 8 or 16 lanes laid out as
+// structure-of-arrays, so each step of the march is a straight loop over lanes that vectorises, and
+// lanes that have hit or escaped are masked out until the whole packet is done. Every ray evaluates the
+// whole scene, so the GPU's tile culling can be checked against it. The image is split into tiles that
+// are spread over a work-stealing thread pool.
+class CpuRaymarcher
+{
+public:
+	explicit CpuRaymarcher(ThreadPool& pool) : m_pool(pool) {};
+
+	// Pixels are stored bottom row first, like the GPU image (gl_GlobalInvocationID.y = 0 is the bottom):
+	void render(const RaymarchParams& params, int width, int height, int packetWidth, std::vector<glm::vec4>& pixels);
+
+	// Primary + shadow steps per pixel in the last render:
+	float getAverageSteps() const { return m_averageSteps; }
+
+	// RMSE and largest absolute difference over the RGB channels of two images of the same size:
+	static void compare(const std::vector<glm::vec4>& a, const std::vector<glm::vec4>& b, float& rmse, float& maxError);
+
+	static bool writePPM(const char* path, const std::vector<glm::vec4>& pixels, int width, int height);
+
+private:
+	ThreadPool& m_pool;
+	float m_averageSteps{};
+};
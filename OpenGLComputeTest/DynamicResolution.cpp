@@ -0,0 +1,66 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution(int maxWidth, int maxHeight, int granularity)
+	: m_maxSize(maxWidth, maxHeight), m_size(maxWidth, maxHeight), m_granularity(granularity)
+{
+}
+
+bool DynamicResolution::update(float milliseconds, float budgetMilliseconds)
+{
+	// Results still in flight were measured at the old size:
+	if (m_settleFrames > 0)
+	{
+		--m_settleFrames;
+		return false;
+	}
+	if (milliseconds <= 0.0f || budgetMilliseconds <= 0.0f)
+		return false;
+
+	// Time goes with the pixel count, i.e. the square of the scale:
+	const float target = m_scale * sqrtf(budgetMilliseconds * TARGET_FRACTION / milliseconds);
+
+	if (milliseconds > budgetMilliseconds)
+	{
+		m_underBudgetFrames = 0;
+		return setScale(target);
+	}
+
+	if (milliseconds < budgetMilliseconds * RAISE_FRACTION && m_scale < 1.0f)
+	{
+		if (++m_underBudgetFrames >= RAISE_FRAMES)
+		{
+			m_underBudgetFrames = 0;
+			return setScale(target);
+		}
+	}
+	else
+		m_underBudgetFrames = 0;
+
+	return false;
+}
+
+void DynamicResolution::reset()
+{
+	setScale(1.0f);
+	m_underBudgetFrames = 0;
+}
+
+bool DynamicResolution::setScale(float scale)
+{
+	scale = std::min(1.0f, std::max(m_minScale, scale));
+
+	// Whole multiples of the granularity, never empty:
+	glm::ivec2 size;
+	size.x = std::max(m_granularity, (int)(m_maxSize.x * scale) / m_granularity * m_granularity);
+	size.y = std::max(m_granularity, (int)(m_maxSize.y * scale) / m_granularity * m_granularity);
+	if (size == m_size)
+		return false;
+
+	// Keep the scale of the size actually used, so the next estimate starts from what was measured:
+	m_size = size;
+	m_scale = (float)size.x / m_maxSize.x;
+	m_settleFrames = SETTLE_FRAMES;
+	return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Picks the resolution the scaled compute passes render at so their GPU time stays inside a budget. Cost is
+// assumed to follow the pixel count, so each change aims for a little under budget. The scale drops as soon
+// as a result is over budget, but only rises after results have stayed under the lower threshold for a
+// while, so it doesn't flip between two sizes. GpuTimer results arrive a few frames late, so results are
+// ignored for a few frames after each change too.
+class DynamicResolution
+{
+public:
+	// Sizes are rounded down to multiples of 'granularity', which should suit every scaled dispatch:
+	DynamicResolution(int maxWidth, int maxHeight, int granularity = 32);
+
+	// Feed the latest GPU time of the scaled passes. Returns true if the resolution changed:
+	bool update(float milliseconds, float budgetMilliseconds);
+
+	// Back to full resolution:
+	void reset();
+
+	void setMinScale(float minScale)	{ m_minScale = minScale; }
+
+	float getScale() const				{ return m_scale; }
+	glm::ivec2 getSize() const			{ return m_size; }
+	glm::ivec2 getMaxSize() const		{ return m_maxSize; }
+	glm::vec2 getUvScale() const		{ return glm::vec2(m_size) / glm::vec2(m_maxSize); }	// Of the rendered sub-rectangle.
+
+private:
+	bool setScale(float scale);
+
+	// Fraction of the budget changes aim for, and below which the scale may rise:
+	static constexpr float TARGET_FRACTION = 0.9f;
+	static constexpr float RAISE_FRACTION = 0.75f;
+
+	static const int SETTLE_FRAMES = 8;		// Results ignored after a change, at least the timer's ring of queries.
+	static const int RAISE_FRAMES = 30;		// Results in a row under RAISE_FRACTION before rising.
+
+	glm::ivec2 m_maxSize{};
+	glm::ivec2 m_size{};
+	int m_granularity{};
+	float m_scale = 1.0f;
+	float m_minScale = 0.25f;
+
+	int m_settleFrames{};
+	int m_underBudgetFrames{};
+};
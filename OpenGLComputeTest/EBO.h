@@ -1,24 +1,27 @@
 #pragma once
-#include "GLObject.h"
+#include "Buffer.h"
 
-class EBO : public GLObject
+class EBO
 {
 public:
-	EBO(unsigned int* data) {
-		glGenBuffers(1, &m_handle);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_handle);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
-		
+	EBO(std::span<const unsigned int> indices, Buffer::Usage usage = Buffer::Usage::STATIC) {
+		m_count = indices.size();
+		m_buffer.init(GL_ELEMENT_ARRAY_BUFFER, indices, usage);
 	}
-	~EBO() {
-		glDeleteBuffers(1, &m_handle);
+	// Replace the indices from 'first' on, for buffers that aren't static:
+	void update(std::span<const unsigned int> indices, size_t first = 0) {
+		m_buffer.update(indices, first);
 	}
-	void bind() {
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_handle);
+	void bind() const {
+		m_buffer.bind();
 	}
-	void unbind() {
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	void unbind() const {
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+	size_t getCount() const {
+		return m_count;
 	}
 private:
+	Buffer m_buffer;
+	size_t m_count{};
 };
-
@@ -0,0 +1,165 @@
+#include "FroxelFog.h"
+
+void FroxelFog::init(int width, int height, int depth)
+{
+	m_size = glm::ivec3(width, height, depth);
+	m_clusterCount = glm::ivec3((width + CLUSTER_WIDTH - 1) / CLUSTER_WIDTH, (height + CLUSTER_HEIGHT - 1) / CLUSTER_HEIGHT,
+		(depth + CLUSTER_DEPTH - 1) / CLUSTER_DEPTH);
+
+	const std::string defines = getShaderDefines();
+	m_lightCullShader.loadShader("res/froxelLightCullShader.comp", defines);
+	m_injectShader.loadShader("res/froxelInjectShader.comp", defines);
+	m_integrateShader.loadShader("res/froxelIntegrateShader.comp", defines);
+	m_compositeShader.loadShader("res/froxelCompositeShader.comp", defines);
+
+	// Only read back through images:
+	m_scatteringTex = TextureHandle::create();
+	GLState::bindTexture(GL_TEXTURE_3D, m_scatteringTex);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexStorage3D(GL_TEXTURE_3D, 1, GL_RGBA16F, width, height, depth);
+
+	// Filtered by the composite, so pixels between froxel centres blend smoothly:
+	m_integratedTex = TextureHandle::create();
+	GLState::bindTexture(GL_TEXTURE_3D, m_integratedTex);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexStorage3D(GL_TEXTURE_3D, 1, GL_RGBA16F, width, height, depth);
+	GLState::bindTexture(GL_TEXTURE_3D, 0);
+
+	m_clusterBuffer = BufferHandle::create();
+	m_paramsBuffer.allocate<GpuParams>(GL_UNIFORM_BUFFER, 1, Buffer::Usage::DYNAMIC);
+}
+
+void FroxelFog::inject(const Params& params, const LightList& lights, const NoiseVolume& noiseVolume, const Table& table, RingBuffer& ring)
+{
+	const int lightCount = lights.getUploadedCount();
+
+	GpuParams gpuParams{};
+	gpuParams.cameraPos = params.cameraPos;
+	gpuParams.aspect = params.aspect;
+	gpuParams.albedo = params.albedo;
+	gpuParams.density = params.density;
+	gpuParams.lutUvScale = table.lutUvScale;
+	gpuParams.baseHeight = params.baseHeight;
+	gpuParams.heightFalloff = params.heightFalloff;
+	gpuParams.noiseAmount = params.noiseAmount;
+	gpuParams.noiseScale = params.noiseScale;
+	gpuParams.gParam = params.gParam;
+	gpuParams.noiseRingOffset = noiseVolume.getRingOffset();
+	gpuParams.noiseDepth = (float)noiseVolume.getDepth();
+	gpuParams.constant = params.constant;
+	gpuParams.linear = params.linear;
+	gpuParams.quadratic = params.quadratic;
+	gpuParams.hooblerZFar = params.hooblerZFar;
+	gpuParams.source = (int)params.source;
+	gpuParams.lightCount = lightCount;
+	gpuParams.kovalovsRange = params.kovalovsRange;
+
+	const RingBuffer::Allocation allocation = ring.pushUniform(gpuParams);
+	if (allocation.data)
+		RingBuffer::bindRange(GL_UNIFORM_BUFFER, FOG_PARAMS_BINDING, allocation);
+	else
+	{
+		m_paramsBuffer.update(0, sizeof(GpuParams), &gpuParams);
+		m_paramsBuffer.bindBase(FOG_PARAMS_BINDING);
+	}
+
+	// Each cluster stores its count followed by room for every light:
+	const size_t clusterBufferSize = (size_t)m_clusterCount.x * m_clusterCount.y * m_clusterCount.z * (lightCount + 1) * sizeof(unsigned int);
+	if (clusterBufferSize > m_clusterBufferSize)
+	{
+		m_clusterBufferSize = clusterBufferSize;
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_clusterBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_clusterBufferSize, NULL, GL_DYNAMIC_COPY);
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	lights.bind();
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_BINDING, m_clusterBuffer);
+
+	m_lightCullShader.use();
+	glDispatchCompute(m_clusterCount.x, m_clusterCount.y, m_clusterCount.z);
+
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	m_injectShader.use();
+	params.distanceWarp.setUniforms(m_injectShader, "u_distance");
+	params.angleWarp.setUniforms(m_injectShader, "u_angle");
+
+	if (table.fit)
+	{
+		table.fit->bind();
+		m_injectShader.setInt("u_fitBands", table.fit->getBands());
+		m_injectShader.setInt("u_fitDegreeU", table.fit->getDegreeU());
+		m_injectShader.setInt("u_fitDegreeV", table.fit->getDegreeV());
+	}
+	m_injectShader.setInt("u_lowRankGroups", table.lowRank ? table.lowRank->getGroupCount() : 0);
+	if (table.lutArray)
+		table.lutArray->setUniforms(m_injectShader);
+
+	m_injectShader.setInt("u_noiseTex", 0);
+	m_injectShader.setInt("u_lut", 1);
+	m_injectShader.setInt("u_rowFactors", 2);
+	m_injectShader.setInt("u_columnFactors", 3);
+	m_injectShader.setInt("u_lutArray", 4);
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_3D, noiseVolume.getTexture());
+	GLState::activeTexture(GL_TEXTURE1);
+	GLState::bindTexture(GL_TEXTURE_2D, table.lut);
+	GLState::activeTexture(GL_TEXTURE2);
+	GLState::bindTexture(GL_TEXTURE_2D, table.lowRank ? table.lowRank->getRowTexture() : 0);
+	GLState::activeTexture(GL_TEXTURE3);
+	GLState::bindTexture(GL_TEXTURE_2D, table.lowRank ? table.lowRank->getColumnTexture() : 0);
+	GLState::activeTexture(GL_TEXTURE4);
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, table.lutArray ? table.lutArray->getTexture() : 0);
+	GLState::activeTexture(GL_TEXTURE0);
+
+	GLState::bindImageTexture(0, m_scatteringTex, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+	// The LUTs and noise were just written through images:
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+	glDispatchCompute((m_size.x + 7) / 8, (m_size.y + 7) / 8, m_size.z);
+}
+
+void FroxelFog::integrate()
+{
+	m_integrateShader.use();
+	GLState::bindImageTexture(0, m_scatteringTex, 0, GL_TRUE, 0, GL_READ_ONLY, GL_RGBA16F);
+	GLState::bindImageTexture(1, m_integratedTex, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+	// One invocation per froxel column, walking its slices:
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glDispatchCompute((m_size.x + 7) / 8, (m_size.y + 7) / 8, 1);
+}
+
+void FroxelFog::composite(unsigned int colourTex, unsigned int depthTex, int width, int height)
+{
+	m_compositeShader.use();
+	m_compositeShader.setInt("u_integrated", 0);
+	m_compositeShader.setIVec2("u_frameSize", glm::ivec2(width, height));
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_3D, m_integratedTex);
+
+	GLState::bindImageTexture(0, colourTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+	GLState::bindImageTexture(3, depthTex, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+}
+
+std::string FroxelFog::getShaderDefines() const
+{
+	return "#define GRID_SIZE ivec3(" + std::to_string(m_size.x) + ", " + std::to_string(m_size.y) + ", " + std::to_string(m_size.z) + ")\n"
+		+ "#define SLICE_NEAR " + std::to_string(NEAR_DIST) + "\n"
+		+ "#define SLICE_FAR " + std::to_string(FAR_DIST) + "\n"
+		+ "#define CLUSTER_SIZE ivec3(" + std::to_string(CLUSTER_WIDTH) + ", " + std::to_string(CLUSTER_HEIGHT) + ", " + std::to_string(CLUSTER_DEPTH) + ")\n"
+		+ "#define CLUSTER_COUNT ivec3(" + std::to_string(m_clusterCount.x) + ", " + std::to_string(m_clusterCount.y) + ", " + std::to_string(m_clusterCount.z) + ")\n"
+		+ "#define LIGHT_BINDING " + std::to_string(LightList::LIGHT_BINDING) + "\n"
+		+ "#define CLUSTER_BINDING " + std::to_string(CLUSTER_BINDING) + "\n"
+		+ "#define FIT_BINDING " + std::to_string(LutFit::FIT_BINDING) + "\n"
+		+ "#define FOG_PARAMS_BINDING " + std::to_string(FOG_PARAMS_BINDING) + "\n";
+}
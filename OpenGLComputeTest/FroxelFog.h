@@ -0,0 +1,143 @@
+#pragma once
+#include "Shader.h"
+#include "NoiseVolume.h"
+#include "LightList.h"
+#include "RingBuffer.h"
+#include "LutFit.h"
+#include "LowRankLut.h"
+#include "LutArray.h"
+#include "LutWarp.h"
+
+// Volumetric fog over the raymarcher's view, held in a grid of froxels (frustum-aligned voxels) whose
+// depth slices are spaced exponentially between NEAR_DIST and FAR_DIST along the camera rays. inject()
+// evaluates the medium and the light's in-scattering at every froxel, either analytically, from one of
+// the baked scattering LUTs (or a LutArray of one over g), or from a compact stand-in for one (LutFit,
+// LowRankLut). Lights are first binned into clusters of froxels, so each froxel only loops over the
+// lights whose range reaches its cluster.
+// integrate() accumulates the froxels front to back into the light scattered towards the camera and the
+// transmittance up to the end of each slice. composite() then applies that to the raymarched image by
+// each pixel's hit distance.
+class FroxelFog
+{
+public:
+	enum class Source {
+		ANALYTIC,		// Henyey-Greenstein phase and each light's attenuation, evaluated per froxel.
+		KOVALOVS_LUT,	// Phase * attenuation looked up by the froxel's offset from each light. Baked for
+						// gParam, so lights with another g are analytic.
+		HOOBLER_LUT,	// Difference of the summed LUT across the slice. Baked for one light distance, so
+						// only the first light uses it and the rest are analytic.
+		KOVALOVS_FIT,	// As the LUT sources, evaluating a LutFit of the LUT instead of sampling it.
+		HOOBLER_FIT,
+		HOOBLER_LOW_RANK,	// As HOOBLER_LUT, rebuilding the LUT from a LowRankLut's factors.
+		KOVALOVS_LUT_ARRAY	// As KOVALOVS_LUT, blending the slices of a LutArray around each light's g.
+	};
+
+	// The table of the params' source, in whichever form it uses. Only the member for the source needs
+	// to be set:
+	struct Table
+	{
+		unsigned int lut{};						// Kovalovs' LUT or Hoobler's summed LUT.
+		glm::vec2 lutUvScale = glm::vec2(1.0f);	// Valid corner of the LUT (see DynamicResolution).
+		const LutFit* fit = nullptr;			// Fitted over that corner.
+		const LowRankLut* lowRank = nullptr;	// Factored over that corner.
+		const LutArray* lutArray = nullptr;		// Baked over whole layers, so lutUvScale doesn't apply.
+	};
+
+	struct Params
+	{
+		Source source = Source::ANALYTIC;
+		glm::vec3 cameraPos{};
+		float aspect = 1.0f;			// Of the raymarched image.
+
+		// Medium:
+		float density{};				// Extinction per unit length at and below baseHeight.
+		glm::vec3 albedo = glm::vec3(1.0f);
+		float baseHeight{};
+		float heightFalloff{};			// Exponential falloff of the density above baseHeight.
+		float noiseAmount{};			// Density is scaled by [1 - amount, 1 + amount] by the noise volume.
+		float noiseScale = 0.1f;		// Noise volume repeats per world unit.
+		float gParam{};					// g the LUTs were baked for. Each light scatters with its own.
+
+		// Attenuation shared by the lights, which fade out to their ranges on top of it. Kovalovs' LUT holds
+		// it out to the same world distance from every light, whatever the light's range:
+		float constant = 1.0f, linear{}, quadratic{};
+		float hooblerZFar = 50.0f;		// u_lightZFar the Hoobler LUT was baked with.
+		float kovalovsRange = 10.0f;	// u_range the Kovalovs LUT was baked with.
+
+		// Axis warps the source's LUT was baked with. Fits and factors are taken in the same warped space:
+		AxisWarp distanceWarp, angleWarp;
+	};
+
+	static constexpr float NEAR_DIST = 0.1f;
+	static constexpr float FAR_DIST = 50.0f;	// Raymarcher's MAX_DIST.
+
+	// Froxels per light cluster:
+	static const int CLUSTER_WIDTH = 10;
+	static const int CLUSTER_HEIGHT = 10;
+	static const int CLUSTER_DEPTH = 4;
+	static const int CLUSTER_BINDING = 6;
+	static const int FOG_PARAMS_BINDING = 0;	// Uniform block.
+
+	FroxelFog() {};
+
+	void init(int width, int height, int depth);
+
+	// Bin the lights into clusters, then inject. The passes' per-frame parameters are written into 'ring',
+	// or into a buffer of the fog's own when it's full or unavailable:
+	void inject(const Params& params, const LightList& lights, const NoiseVolume& noiseVolume,
+		const Table& table, RingBuffer& ring);
+	void integrate();
+
+	// Fog the width x height region at the origin of 'colourTex' (RGBA32F, gamma encoded) in place, by the
+	// hit distances in 'depthTex' (R32F):
+	void composite(unsigned int colourTex, unsigned int depthTex, int width, int height);
+
+	unsigned int getScatteringTexture() const	{ return m_scatteringTex; }
+	unsigned int getIntegratedTexture() const	{ return m_integratedTex; }
+	glm::ivec3 getSize() const					{ return m_size; }
+	glm::ivec3 getClusterCount() const			{ return m_clusterCount; }
+
+private:
+	// Mirrors FogParams (res/froxelParams.glsl, std140):
+	struct GpuParams
+	{
+		glm::vec3 cameraPos;
+		float aspect;
+		glm::vec3 albedo;
+		float density;
+		glm::vec2 lutUvScale;
+		float baseHeight;
+		float heightFalloff;
+		float noiseAmount;
+		float noiseScale;
+		float gParam;
+		float noiseRingOffset;
+		float noiseDepth;
+		float constant;
+		float linear;
+		float quadratic;
+		float hooblerZFar;
+		int source;
+		int lightCount;
+		float kovalovsRange;
+	};
+	static_assert(sizeof(GpuParams) == 96, "GpuParams must match the std140 layout of FogParams");
+
+	std::string getShaderDefines() const;
+
+	Shader m_lightCullShader;
+	Shader m_injectShader;
+	Shader m_integrateShader;
+	Shader m_compositeShader;
+
+	TextureHandle m_scatteringTex;		// In-scattered light per unit length (RGB) and extinction (A).
+	TextureHandle m_integratedTex;		// Light scattered towards the camera (RGB) and transmittance (A).
+	glm::ivec3 m_size{};
+
+	// Per cluster: the number of lights reaching it followed by their indices:
+	BufferHandle m_clusterBuffer;
+	size_t m_clusterBufferSize{};
+
+	Buffer m_paramsBuffer;		// Fallback for the ring.
+	glm::ivec3 m_clusterCount{};
+};
@@ -0,0 +1,29 @@
+#include "FullscreenPass.h"
+
+void FullscreenPass::init()
+{
+	m_emptyVAO = VertexArrayHandle::create();
+	m_readFramebuffer = FramebufferHandle::create();
+}
+
+void FullscreenPass::draw() const
+{
+	m_emptyVAO.bind();
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void FullscreenPass::present(GLuint texture, int width, int height, int dstWidth, int dstHeight) const
+{
+	m_readFramebuffer.bind(GL_READ_FRAMEBUFFER);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+	// Filtered only when it's actually scaled:
+	const GLenum filter = width == dstWidth && height == dstHeight ? GL_NEAREST : GL_LINEAR;
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, dstWidth, dstHeight, GL_COLOR_BUFFER_BIT, filter);
+
+	// Detached so the texture isn't kept as a read source:
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "GLHandle.h"
+
+// Full-screen passes without a vertex buffer. draw() issues one triangle that overhangs the screen, its
+// corners made from gl_VertexID by res/fullscreenTriangle.vert, so there is no vertex fetch and no
+// diagonal seam where the two halves of a quad shade the same pixels' helper lanes twice. Pair that
+// vertex shader with any fragment shader taking 'in vec2 TexCoords' ([0, 1] over the screen).
+// Images that need no shading at all can be present()ed instead, which blits them straight to the
+// default framebuffer.
+class FullscreenPass
+{
+public:
+	static constexpr const char* VERTEX_SHADER_PATH = "res/fullscreenTriangle.vert";
+
+	FullscreenPass() {};
+
+	void init();
+
+	// With the pass's program already in use:
+	void draw() const;
+
+	// Stretch the width x height region at the origin of level 0 of 'texture' (2D, non-integer format)
+	// over the default framebuffer's dstWidth x dstHeight. Image stores into it need a
+	// GL_FRAMEBUFFER_BARRIER_BIT barrier first:
+	void present(GLuint texture, int width, int height, int dstWidth, int dstHeight) const;
+
+private:
+	VertexArrayHandle m_emptyVAO;		// Core profiles draw nothing without one bound.
+	FramebufferHandle m_readFramebuffer;
+};
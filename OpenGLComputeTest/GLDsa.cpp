@@ -0,0 +1,95 @@
+#include "GLDsa.h"
+#include <cstring>
+
+GLDsa::CreateTexturesProc GLDsa::createTextures;
+GLDsa::CreateObjectsProc GLDsa::createBuffers;
+GLDsa::CreateObjectsProc GLDsa::createVertexArrays;
+GLDsa::TextureParameteriProc GLDsa::textureParameteri;
+GLDsa::TextureStorage2DProc GLDsa::textureStorage2D;
+GLDsa::NamedBufferStorageProc GLDsa::namedBufferStorage;
+GLDsa::NamedBufferDataProc GLDsa::namedBufferData;
+GLDsa::NamedBufferSubDataProc GLDsa::namedBufferSubData;
+GLDsa::MapNamedBufferRangeProc GLDsa::mapNamedBufferRange;
+GLDsa::UnmapNamedBufferProc GLDsa::unmapNamedBuffer;
+GLDsa::VertexArrayVertexBufferProc GLDsa::vertexArrayVertexBuffer;
+GLDsa::VertexArrayAttribFormatProc GLDsa::vertexArrayAttribFormat;
+GLDsa::VertexArrayAttribBindingProc GLDsa::vertexArrayAttribBinding;
+GLDsa::EnableVertexArrayAttribProc GLDsa::enableVertexArrayAttrib;
+
+namespace
+{
+	bool g_available = false;
+
+	bool hasExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i)
+			if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0)
+				return true;
+		return false;
+	}
+
+	template <typename Proc>
+	bool loadProc(GLADloadproc loader, const char* name, Proc& proc)
+	{
+		proc = (Proc)loader(name);
+		return proc != nullptr;
+	}
+}
+
+bool GLDsa::load(GLADloadproc loader)
+{
+	GLint major = 0, minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if ((major < 4 || (major == 4 && minor < 5)) && !hasExtension("GL_ARB_direct_state_access"))
+		return false;
+
+	// The 4.5 core names, which the extension shares:
+	g_available = loadProc(loader, "glCreateTextures", createTextures)
+		&& loadProc(loader, "glCreateBuffers", createBuffers)
+		&& loadProc(loader, "glCreateVertexArrays", createVertexArrays)
+		&& loadProc(loader, "glTextureParameteri", textureParameteri)
+		&& loadProc(loader, "glTextureStorage2D", textureStorage2D)
+		&& loadProc(loader, "glNamedBufferStorage", namedBufferStorage)
+		&& loadProc(loader, "glNamedBufferData", namedBufferData)
+		&& loadProc(loader, "glNamedBufferSubData", namedBufferSubData)
+		&& loadProc(loader, "glMapNamedBufferRange", mapNamedBufferRange)
+		&& loadProc(loader, "glUnmapNamedBuffer", unmapNamedBuffer)
+		&& loadProc(loader, "glVertexArrayVertexBuffer", vertexArrayVertexBuffer)
+		&& loadProc(loader, "glVertexArrayAttribFormat", vertexArrayAttribFormat)
+		&& loadProc(loader, "glVertexArrayAttribBinding", vertexArrayAttribBinding)
+		&& loadProc(loader, "glEnableVertexArrayAttrib", enableVertexArrayAttrib);
+	return g_available;
+}
+
+bool GLDsa::isAvailable()
+{
+	return g_available;
+}
+
+TextureHandle GLDsa::createTexture2D(GLenum internalFormat, int width, int height, int levels, GLenum minFilter, GLenum magFilter)
+{
+	if (g_available)
+	{
+		GLuint name;
+		createTextures(GL_TEXTURE_2D, 1, &name);
+		textureParameteri(name, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		textureParameteri(name, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		textureParameteri(name, GL_TEXTURE_MAG_FILTER, magFilter);
+		textureParameteri(name, GL_TEXTURE_MIN_FILTER, minFilter);
+		textureStorage2D(name, levels, internalFormat, width, height);
+		return TextureHandle(name);
+	}
+
+	// Binds to whichever unit is active:
+	TextureHandle texture = TextureHandle::create();
+	texture.bind(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+	glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height);
+	return texture;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "GLHandle.h"
+
+// GL 4.4 buffer storage flags, which glad's 4.3 header doesn't have:
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT	0x0040
+#define GL_MAP_COHERENT_BIT		0x0080
+#define GL_DYNAMIC_STORAGE_BIT	0x0100
+#endif
+
+// GL 4.5 direct state access, loaded by hand since glad is generated for 4.3. Objects made through here
+// are created and filled by name, so setting one up neither binds it nor depends on what is bound, and
+// GLState's shadow is left alone. Without a 4.5 context or ARB_direct_state_access, or before load(),
+// the same functions fall back to 4.3 bind-to-edit calls.
+class GLDsa
+{
+public:
+	typedef void (APIENTRYP CreateObjectsProc)(GLsizei n, GLuint* names);
+	typedef void (APIENTRYP CreateTexturesProc)(GLenum target, GLsizei n, GLuint* textures);
+	typedef void (APIENTRYP TextureParameteriProc)(GLuint texture, GLenum pname, GLint param);
+	typedef void (APIENTRYP TextureStorage2DProc)(GLuint texture, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height);
+	typedef void (APIENTRYP NamedBufferStorageProc)(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags);
+	typedef void (APIENTRYP NamedBufferDataProc)(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage);
+	typedef void (APIENTRYP NamedBufferSubDataProc)(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+	typedef void* (APIENTRYP MapNamedBufferRangeProc)(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access);
+	typedef GLboolean (APIENTRYP UnmapNamedBufferProc)(GLuint buffer);
+	typedef void (APIENTRYP VertexArrayVertexBufferProc)(GLuint vao, GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride);
+	typedef void (APIENTRYP VertexArrayAttribFormatProc)(GLuint vao, GLuint attrib, GLint size, GLenum type, GLboolean normalised, GLuint offset);
+	typedef void (APIENTRYP VertexArrayAttribBindingProc)(GLuint vao, GLuint attrib, GLuint binding);
+	typedef void (APIENTRYP EnableVertexArrayAttribProc)(GLuint vao, GLuint index);
+
+	static CreateTexturesProc createTextures;
+	static CreateObjectsProc createBuffers;
+	static CreateObjectsProc createVertexArrays;
+	static TextureParameteriProc textureParameteri;
+	static TextureStorage2DProc textureStorage2D;
+	static NamedBufferStorageProc namedBufferStorage;
+	static NamedBufferDataProc namedBufferData;
+	static NamedBufferSubDataProc namedBufferSubData;
+	static MapNamedBufferRangeProc mapNamedBufferRange;
+	static UnmapNamedBufferProc unmapNamedBuffer;
+	static VertexArrayVertexBufferProc vertexArrayVertexBuffer;
+	static VertexArrayAttribFormatProc vertexArrayAttribFormat;
+	static VertexArrayAttribBindingProc vertexArrayAttribBinding;
+	static EnableVertexArrayAttribProc enableVertexArrayAttrib;
+
+	// Load the entry points once the context is current. False if the context doesn't have them:
+	static bool load(GLADloadproc loader);
+	static bool isAvailable();
+
+	// Clamped 2D texture with immutable storage:
+	static TextureHandle createTexture2D(GLenum internalFormat, int width, int height, int levels, GLenum minFilter, GLenum magFilter);
+};
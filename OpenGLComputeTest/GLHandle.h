@@ -0,0 +1,113 @@
+#pragma once
+#include "GLState.h"
+
+// Owner of one GL object name, deleted through Traits when the handle is destroyed or reset. Move-only, so
+// a name can't be deleted twice through a copy or leaked by being overwritten. Converts to the raw name
+// for GL calls, and bind() forwards straight to the object's glBind*() (e.g. tex.bind(GL_TEXTURE_2D),
+// vao.bind()) through GLState's cache without any virtual dispatch.
+template <typename Traits>
+class GLHandle
+{
+public:
+	typedef typename Traits::Name Name;
+
+	GLHandle() {};
+	explicit GLHandle(Name name) : m_name(name) {};
+	~GLHandle()											{ reset(); }
+
+	GLHandle(const GLHandle&) = delete;
+	GLHandle& operator=(const GLHandle&) = delete;
+	GLHandle(GLHandle&& other) noexcept : m_name(other.release()) {};
+	GLHandle& operator=(GLHandle&& other) noexcept		{ reset(other.release()); return *this; }
+
+	// A new object, for the types with a glGen*() or glCreate*():
+	static GLHandle create()							{ return GLHandle(Traits::create()); }
+
+	template <typename... Args>
+	void bind(Args... args) const						{ Traits::bind(args..., m_name); }
+
+	// Delete the current object, taking ownership of 'name' instead:
+	void reset(Name name = Name())
+	{
+		if (m_name && m_name != name)
+			Traits::destroy(m_name);
+		m_name = name;
+	}
+
+	// Give up ownership without deleting:
+	Name release()
+	{
+		Name name = m_name;
+		m_name = Name();
+		return name;
+	}
+
+	Name get() const									{ return m_name; }
+	operator Name() const								{ return m_name; }
+
+private:
+	Name m_name{};
+};
+
+struct TextureTraits
+{
+	typedef GLuint Name;
+	static GLuint create()								{ GLuint name; glGenTextures(1, &name); return name; }
+	static void destroy(GLuint name)					{ GLState::forgetTexture(name); glDeleteTextures(1, &name); }
+	static void bind(GLenum target, GLuint name)		{ GLState::bindTexture(target, name); }
+};
+
+struct BufferTraits
+{
+	typedef GLuint Name;
+	static GLuint create()								{ GLuint name; glGenBuffers(1, &name); return name; }
+	static void destroy(GLuint name)					{ GLState::forgetBuffer(name); glDeleteBuffers(1, &name); }
+	static void bind(GLenum target, GLuint name)		{ GLState::bindBuffer(target, name); }
+};
+
+struct VertexArrayTraits
+{
+	typedef GLuint Name;
+	static GLuint create()								{ GLuint name; glGenVertexArrays(1, &name); return name; }
+	static void destroy(GLuint name)					{ GLState::forgetVertexArray(name); glDeleteVertexArrays(1, &name); }
+	static void bind(GLuint name)						{ GLState::bindVertexArray(name); }
+};
+
+struct ProgramTraits
+{
+	typedef GLuint Name;
+	static GLuint create()								{ return glCreateProgram(); }
+	static void destroy(GLuint name)					{ GLState::forgetProgram(name); glDeleteProgram(name); }
+	static void bind(GLuint name)						{ GLState::useProgram(name); }
+};
+
+struct QueryTraits
+{
+	typedef GLuint Name;
+	static GLuint create()								{ GLuint name; glGenQueries(1, &name); return name; }
+	static void destroy(GLuint name)					{ glDeleteQueries(1, &name); }
+};
+
+// Framebuffer bindings aren't cached by GLState, so they go straight through:
+struct FramebufferTraits
+{
+	typedef GLuint Name;
+	static GLuint create()								{ GLuint name; glGenFramebuffers(1, &name); return name; }
+	static void destroy(GLuint name)					{ glDeleteFramebuffers(1, &name); }
+	static void bind(GLenum target, GLuint name)		{ glBindFramebuffer(target, name); }
+};
+
+// Fences are made by glFenceSync() when they're issued, so there's no create():
+struct SyncTraits
+{
+	typedef GLsync Name;
+	static void destroy(GLsync name)					{ glDeleteSync(name); }
+};
+
+typedef GLHandle<TextureTraits>		TextureHandle;
+typedef GLHandle<BufferTraits>		BufferHandle;
+typedef GLHandle<VertexArrayTraits>	VertexArrayHandle;
+typedef GLHandle<ProgramTraits>		ProgramHandle;
+typedef GLHandle<QueryTraits>		QueryHandle;
+typedef GLHandle<FramebufferTraits>	FramebufferHandle;
+typedef GLHandle<SyncTraits>		SyncHandle;
@@ -0,0 +1,277 @@
+#include "GLState.h"
+#include <algorithm>
+
+namespace
+{
+	// Never a real name, so the first bind after invalidate() always goes through:
+	const GLuint UNKNOWN = ~0u;
+
+	const int MAX_TEXTURE_UNITS = 32;
+	const int MAX_IMAGE_UNITS = 16;
+	const int MAX_BUFFER_INDICES = 16;
+
+	// Binds to anything else are still issued, just never elided:
+	const GLenum TEXTURE_TARGETS[] = { GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_3D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP };
+	const GLenum BUFFER_TARGETS[] = { GL_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_PIXEL_PACK_BUFFER,
+		GL_PIXEL_UNPACK_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_UNIFORM_BUFFER, GL_ATOMIC_COUNTER_BUFFER,
+		GL_DISPATCH_INDIRECT_BUFFER, GL_DRAW_INDIRECT_BUFFER };
+	const GLenum INDEXED_TARGETS[] = { GL_SHADER_STORAGE_BUFFER, GL_UNIFORM_BUFFER, GL_ATOMIC_COUNTER_BUFFER };
+
+	const int TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(GLenum);
+	const int BUFFER_TARGET_COUNT = sizeof(BUFFER_TARGETS) / sizeof(GLenum);
+	const int INDEXED_TARGET_COUNT = sizeof(INDEXED_TARGETS) / sizeof(GLenum);
+
+	const char* CALL_NAMES[] = { "glUseProgram", "glActiveTexture", "glBindTexture", "glBindImageTexture",
+		"glBindVertexArray", "glBindBuffer", "glBindBufferBase", "glBindBufferRange" };
+
+	struct ImageBinding
+	{
+		GLuint texture;
+		GLint level;
+		GLboolean layered;
+		GLint layer;
+		GLenum access;
+		GLenum format;
+
+		bool operator==(const ImageBinding& other) const
+		{
+			return texture == other.texture && level == other.level && layered == other.layered && layer == other.layer
+				&& access == other.access && format == other.format;
+		}
+	};
+
+	// Size -1 for the whole buffer, as bound by glBindBufferBase():
+	struct BufferBinding
+	{
+		GLuint buffer;
+		GLintptr offset;
+		GLsizeiptr size;
+
+		bool operator==(const BufferBinding& other) const
+		{
+			return buffer == other.buffer && offset == other.offset && size == other.size;
+		}
+	};
+
+	struct State
+	{
+		GLuint program;
+		int activeUnit;		// -1 when unknown.
+		GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+		ImageBinding images[MAX_IMAGE_UNITS];
+		GLuint vertexArray;
+		GLuint buffers[BUFFER_TARGET_COUNT];
+		BufferBinding indexedBuffers[INDEXED_TARGET_COUNT][MAX_BUFFER_INDICES];
+
+		State() { clear(); }
+
+		void clear()
+		{
+			program = UNKNOWN;
+			activeUnit = -1;
+			std::fill(&textures[0][0], &textures[0][0] + MAX_TEXTURE_UNITS * TEXTURE_TARGET_COUNT, UNKNOWN);
+			for (ImageBinding& image : images)
+				image.texture = UNKNOWN;
+			vertexArray = UNKNOWN;
+			std::fill(buffers, buffers + BUFFER_TARGET_COUNT, UNKNOWN);
+			for (auto& bindings : indexedBuffers)
+				for (BufferBinding& binding : bindings)
+					binding.buffer = UNKNOWN;
+		}
+	};
+
+	State g_state;
+	GLState::Counters g_counters;
+	bool g_elisionEnabled = true;
+
+	template <size_t N>
+	int findTarget(const GLenum (&targets)[N], GLenum target)
+	{
+		for (size_t i = 0; i < N; ++i)
+			if (targets[i] == target)
+				return (int)i;
+		return -1;
+	}
+
+	// Counts the call, and whether it still has to be issued:
+	bool needsCall(GLState::Call call, bool redundant)
+	{
+		if (redundant && g_elisionEnabled)
+		{
+			++g_counters.elided[(int)call];
+			return false;
+		}
+		++g_counters.issued[(int)call];
+		return true;
+	}
+
+	void bindIndexed(GLState::Call call, GLenum target, GLuint index, const BufferBinding& bind)
+	{
+		// Both calls bind the generic target too, which later glBufferData() calls may rely on:
+		const int targetIndex = findTarget(INDEXED_TARGETS, target);
+		const int genericIndex = findTarget(BUFFER_TARGETS, target);
+		BufferBinding* binding = targetIndex >= 0 && index < MAX_BUFFER_INDICES ? &g_state.indexedBuffers[targetIndex][index] : nullptr;
+		GLuint* generic = genericIndex >= 0 ? &g_state.buffers[genericIndex] : nullptr;
+		if (!needsCall(call, binding && generic && *binding == bind && *generic == bind.buffer))
+			return;
+
+		if (bind.size < 0)
+			glBindBufferBase(target, index, bind.buffer);
+		else
+			glBindBufferRange(target, index, bind.buffer, bind.offset, bind.size);
+		if (binding)
+			*binding = bind;
+		if (generic)
+			*generic = bind.buffer;
+	}
+}
+
+unsigned int GLState::Counters::getIssued() const
+{
+	unsigned int total = 0;
+	for (unsigned int count : issued)
+		total += count;
+	return total;
+}
+
+unsigned int GLState::Counters::getElided() const
+{
+	unsigned int total = 0;
+	for (unsigned int count : elided)
+		total += count;
+	return total;
+}
+
+void GLState::useProgram(GLuint program)
+{
+	if (!needsCall(Call::PROGRAM, g_state.program == program))
+		return;
+
+	glUseProgram(program);
+	g_state.program = program;
+}
+
+void GLState::activeTexture(GLenum texture)
+{
+	const int unit = (int)(texture - GL_TEXTURE0);
+	if (!needsCall(Call::ACTIVE_TEXTURE, g_state.activeUnit == unit))
+		return;
+
+	glActiveTexture(texture);
+	g_state.activeUnit = unit;
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+	const int unit = g_state.activeUnit;
+	const int index = findTarget(TEXTURE_TARGETS, target);
+	GLuint* binding = unit >= 0 && unit < MAX_TEXTURE_UNITS && index >= 0 ? &g_state.textures[unit][index] : nullptr;
+	if (!needsCall(Call::TEXTURE, binding && *binding == texture))
+		return;
+
+	glBindTexture(target, texture);
+	if (binding)
+		*binding = texture;
+}
+
+void GLState::bindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format)
+{
+	const ImageBinding image = { texture, level, layered, layer, access, format };
+	ImageBinding* binding = unit < MAX_IMAGE_UNITS ? &g_state.images[unit] : nullptr;
+	if (!needsCall(Call::IMAGE_TEXTURE, binding && *binding == image))
+		return;
+
+	glBindImageTexture(unit, texture, level, layered, layer, access, format);
+	if (binding)
+		*binding = image;
+}
+
+void GLState::bindVertexArray(GLuint array)
+{
+	if (!needsCall(Call::VERTEX_ARRAY, g_state.vertexArray == array))
+		return;
+
+	glBindVertexArray(array);
+	g_state.vertexArray = array;
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+	const int index = findTarget(BUFFER_TARGETS, target);
+	GLuint* binding = index >= 0 ? &g_state.buffers[index] : nullptr;
+	if (!needsCall(Call::BUFFER, binding && *binding == buffer))
+		return;
+
+	glBindBuffer(target, buffer);
+	if (binding)
+		*binding = buffer;
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	bindIndexed(Call::BUFFER_BASE, target, index, { buffer, 0, -1 });
+}
+
+void GLState::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	bindIndexed(Call::BUFFER_RANGE, target, index, { buffer, offset, size });
+}
+
+void GLState::forgetProgram(GLuint program)
+{
+	if (g_state.program == program)
+		g_state.program = UNKNOWN;
+}
+
+void GLState::forgetTexture(GLuint texture)
+{
+	std::replace(&g_state.textures[0][0], &g_state.textures[0][0] + MAX_TEXTURE_UNITS * TEXTURE_TARGET_COUNT, texture, UNKNOWN);
+	for (ImageBinding& image : g_state.images)
+		if (image.texture == texture)
+			image.texture = UNKNOWN;
+}
+
+void GLState::forgetVertexArray(GLuint array)
+{
+	if (g_state.vertexArray == array)
+		g_state.vertexArray = UNKNOWN;
+}
+
+void GLState::forgetBuffer(GLuint buffer)
+{
+	std::replace(g_state.buffers, g_state.buffers + BUFFER_TARGET_COUNT, buffer, UNKNOWN);
+	for (auto& bindings : g_state.indexedBuffers)
+		for (BufferBinding& binding : bindings)
+			if (binding.buffer == buffer)
+				binding.buffer = UNKNOWN;
+}
+
+void GLState::invalidate()
+{
+	g_state.clear();
+}
+
+void GLState::setElisionEnabled(bool enabled)
+{
+	g_elisionEnabled = enabled;
+}
+
+bool GLState::isElisionEnabled()
+{
+	return g_elisionEnabled;
+}
+
+const GLState::Counters& GLState::getCounters()
+{
+	return g_counters;
+}
+
+void GLState::resetCounters()
+{
+	g_counters = Counters();
+}
+
+const char* GLState::getCallName(Call call)
+{
+	return CALL_NAMES[(int)call];
+}
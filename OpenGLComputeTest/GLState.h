@@ -0,0 +1,50 @@
+#pragma once
+#include <glad4.3/glad4.3.h>
+
+// Shadow of the context's program, texture unit, image unit, vertex array and buffer bindings, so that a
+// bind which wouldn't change anything is dropped before it reaches the driver. Each function takes the
+// same arguments as the GL call it replaces. Every bind of a tracked binding has to go through here, or
+// be followed by invalidate(), or the shadow goes stale; GLHandle tells it when objects are deleted,
+// since GL unbinds them. Bindings that belong to another object, such as GL_ELEMENT_ARRAY_BUFFER which
+// is vertex array state, are passed straight through.
+class GLState
+{
+public:
+	enum class Call { PROGRAM, ACTIVE_TEXTURE, TEXTURE, IMAGE_TEXTURE, VERTEX_ARRAY, BUFFER, BUFFER_BASE, BUFFER_RANGE, COUNT };
+
+	struct Counters
+	{
+		unsigned int issued[(int)Call::COUNT]{};
+		unsigned int elided[(int)Call::COUNT]{};
+
+		unsigned int getIssued() const;
+		unsigned int getElided() const;
+	};
+
+	static void useProgram(GLuint program);
+	static void activeTexture(GLenum texture);
+	static void bindTexture(GLenum target, GLuint texture);
+	static void bindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
+	static void bindVertexArray(GLuint array);
+	static void bindBuffer(GLenum target, GLuint buffer);
+	static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	static void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+	// Drop every binding of a name that is about to be deleted:
+	static void forgetProgram(GLuint program);
+	static void forgetTexture(GLuint texture);
+	static void forgetVertexArray(GLuint array);
+	static void forgetBuffer(GLuint buffer);
+
+	// Assume nothing about the context, after binds made behind the cache's back:
+	static void invalidate();
+
+	// With elision off every call is issued, to compare against:
+	static void setElisionEnabled(bool enabled);
+	static bool isElisionEnabled();
+
+	// Calls since the last reset:
+	static const Counters& getCounters();
+	static void resetCounters();
+	static const char* getCallName(Call call);
+};
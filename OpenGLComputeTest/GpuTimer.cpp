@@ -0,0 +1,48 @@
+#include "GpuTimer.h"
+
+void GpuTimer::init()
+{
+	for (QueryHandle& query : m_queries)
+		query = QueryHandle::create();
+}
+
+void GpuTimer::begin()
+{
+	m_active = !m_pending[m_writeIndex];
+	if (m_active)
+		glBeginQuery(GL_TIME_ELAPSED, m_queries[m_writeIndex]);
+}
+
+void GpuTimer::end()
+{
+	if (!m_active)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	m_pending[m_writeIndex] = true;
+	m_writeIndex = (m_writeIndex + 1) % QUERY_COUNT;
+	m_active = false;
+}
+
+bool GpuTimer::poll()
+{
+	bool found = false;
+
+	while (m_pending[m_readIndex])
+	{
+		int available = 0;
+		glGetQueryObjectiv(m_queries[m_readIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(m_queries[m_readIndex], GL_QUERY_RESULT, &nanoseconds);
+		m_milliseconds = (float)(nanoseconds / 1.0e6);
+		m_average = m_average == 0.0f ? m_milliseconds : m_average * 0.9f + m_milliseconds * 0.1f;
+
+		m_pending[m_readIndex] = false;
+		m_readIndex = (m_readIndex + 1) % QUERY_COUNT;
+		found = true;
+	}
+	return found;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "GLHandle.h"
+
+// GL_TIME_ELAPSED query around a pass. Queries are kept in a small ring so results are collected a few
+// frames late instead of stalling on the one just issued.
+class GpuTimer
+{
+public:
+	GpuTimer() {};
+
+	void init();
+
+	// Bracket the GL commands to time. Skipped if every query in the ring is still in flight:
+	void begin();
+	void end();
+
+	// Collect any finished queries. Returns true if a new result arrived:
+	bool poll();
+
+	float getMilliseconds() const			{ return m_milliseconds; }	// Latest result.
+	float getAverageMilliseconds() const	{ return m_average; }		// Exponential moving average.
+
+private:
+	static const int QUERY_COUNT = 4;
+
+	QueryHandle m_queries[QUERY_COUNT];
+	bool m_pending[QUERY_COUNT]{};
+	int m_writeIndex{};
+	int m_readIndex{};
+	bool m_active = false;
+
+	float m_milliseconds{};
+	float m_average{};
+};
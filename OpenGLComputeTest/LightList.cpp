@@ -0,0 +1,64 @@
+#include "LightList.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+void LightList::init()
+{
+	// Rewritten every frame the fog runs, so sized once for every light and streamed:
+	m_lightBuffer.allocate<GpuLight>(GL_SHADER_STORAGE_BUFFER, MAX_LIGHTS, Buffer::Usage::STREAM);
+}
+
+void LightList::upload()
+{
+	m_uploadedCount = std::min((int)m_lights.size(), MAX_LIGHTS);
+	m_gpuLights.resize(m_uploadedCount);
+	for (int i = 0; i < m_uploadedCount; ++i)
+		m_gpuLights[i] = buildGpuLight(m_lights[i]);
+	m_lightBuffer.update(std::span<const GpuLight>(m_gpuLights));
+}
+
+void LightList::bind() const
+{
+	m_lightBuffer.bindBase(LIGHT_BINDING);
+}
+
+std::vector<LightList::Light> LightList::generateRandom(int count, const glm::vec3& boundsMin, const glm::vec3& boundsMax, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<Light> lights(count);
+	for (Light& light : lights)
+	{
+		light.type = unit(rng) < 0.5f ? Type::POINT : Type::SPOT;
+		light.position = boundsMin + (boundsMax - boundsMin) * glm::vec3(unit(rng), unit(rng), unit(rng));
+		light.colour = glm::vec3(unit(rng), unit(rng), unit(rng)) * 4.0f;
+		light.range = 1.0f + unit(rng) * 3.0f;
+
+		// Spots point mostly downwards:
+		light.direction = glm::normalize(glm::vec3(unit(rng) - 0.5f, -1.0f, unit(rng) - 0.5f));
+		light.outerAngle = 15.0f + unit(rng) * 30.0f;
+		light.innerAngle = light.outerAngle * 0.7f;
+		light.g = unit(rng) * 1.8f - 0.9f;
+	}
+	return lights;
+}
+
+GpuLight LightList::buildGpuLight(const Light& light)
+{
+	GpuLight gpuLight;
+	gpuLight.positionRange = glm::vec4(light.position, light.range);
+	gpuLight.phase = glm::vec4(light.g, 0.0f, 0.0f, 0.0f);
+	if (light.type == Type::SPOT)
+	{
+		gpuLight.colourInner = glm::vec4(light.colour, cosf(glm::radians(light.innerAngle)));
+		gpuLight.directionOuter = glm::vec4(glm::normalize(light.direction), cosf(glm::radians(light.outerAngle)));
+	}
+	else
+	{
+		gpuLight.colourInner = glm::vec4(light.colour, -2.0f);
+		gpuLight.directionOuter = glm::vec4(0.0f, 0.0f, 0.0f, -2.0f);
+	}
+	return gpuLight;
+}
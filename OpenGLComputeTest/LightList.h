@@ -0,0 +1,63 @@
+#pragma once
+#include "Shader.h"
+#include "Buffer.h"
+#include <vector>
+
+// Mirrors the std430 Light struct of the fog shaders:
+struct GpuLight
+{
+	glm::vec4 positionRange;	// World position, and the distance at which the light has faded out.
+	glm::vec4 colourInner;		// RGB intensity, and the cosine of a spot light's inner cone.
+	glm::vec4 directionOuter;	// Unit spot direction, and the cosine of the outer cone (-2 for point lights).
+	glm::vec4 phase;			// Henyey-Greenstein g of the light's scattering in x, the rest unused.
+};
+
+// Point and spot lights for the scattering passes, uploaded to an SSBO. Every light has a finite range, so
+// FroxelFog can bin them into clusters of froxels and each froxel only evaluates the lights that reach it.
+class LightList
+{
+public:
+	enum class Type {
+		POINT,
+		SPOT
+	};
+
+	// Editable description of a light, converted to a GpuLight on upload:
+	struct Light
+	{
+		Type type = Type::POINT;
+		glm::vec3 position{};
+		glm::vec3 colour = glm::vec3(1.0f);
+		float range = 10.0f;
+		glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);	// Spot lights only.
+		float innerAngle = 20.0f;								// Half angles in degrees, spot lights only.
+		float outerAngle = 30.0f;
+		float g{};						// Henyey-Greenstein anisotropy of the light's scattering.
+	};
+
+	static const int MAX_LIGHTS = 4096;
+	static const int LIGHT_BINDING = 5;
+
+	LightList() {};
+
+	void init();
+
+	// Upload the lights, dropping any past MAX_LIGHTS:
+	void upload();
+
+	void bind() const;
+
+	std::vector<Light>& getLights()		{ return m_lights; }
+	int getUploadedCount() const		{ return m_uploadedCount; }
+
+	// 'count' lights scattered through the box, a mix of point and spot lights with random colours and g:
+	static std::vector<Light> generateRandom(int count, const glm::vec3& boundsMin, const glm::vec3& boundsMax, unsigned int seed);
+
+	static GpuLight buildGpuLight(const Light& light);
+
+private:
+	std::vector<Light> m_lights;
+	std::vector<GpuLight> m_gpuLights;
+	Buffer m_lightBuffer;
+	int m_uploadedCount{};
+};
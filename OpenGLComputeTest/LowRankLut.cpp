@@ -0,0 +1,233 @@
+#include "LowRankLut.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace
+{
+	typedef std::vector<std::vector<double>> Vectors;
+
+	const int COLUMN_BLOCK = 64;
+	const int OVERSAMPLING = 4;		// Extra vectors iterated so the kept ranks converge faster.
+
+	// Modified Gram-Schmidt. Vectors that collapse (the table has lower rank) are left at zero:
+	void orthonormalise(Vectors& vectors)
+	{
+		for (size_t i = 0; i < vectors.size(); ++i)
+		{
+			for (size_t j = 0; j < i; ++j)
+			{
+				double d = std::inner_product(vectors[i].begin(), vectors[i].end(), vectors[j].begin(), 0.0);
+				for (size_t k = 0; k < vectors[i].size(); ++k)
+					vectors[i][k] -= d * vectors[j][k];
+			}
+
+			double norm = sqrt(std::inner_product(vectors[i].begin(), vectors[i].end(), vectors[i].begin(), 0.0));
+			for (double& x : vectors[i])
+				x = norm > 1e-300 ? x / norm : 0.0;
+		}
+	}
+
+	// Cyclic Jacobi eigendecomposition of a small symmetric matrix. Eigenvalues are left on the diagonal
+	// of 'a' and eigenvectors in the columns of 'v':
+	void jacobiEigen(std::vector<double>& a, std::vector<double>& v, int n)
+	{
+		v.assign((size_t)n * n, 0.0);
+		for (int i = 0; i < n; ++i)
+			v[i * n + i] = 1.0;
+
+		for (int sweep = 0; sweep < 50; ++sweep)
+		{
+			double offDiagonal = 0.0;
+			for (int p = 0; p < n; ++p)
+				for (int q = p + 1; q < n; ++q)
+					offDiagonal += a[p * n + q] * a[p * n + q];
+			if (offDiagonal < 1e-30)
+				break;
+
+			for (int p = 0; p < n; ++p)
+			{
+				for (int q = p + 1; q < n; ++q)
+				{
+					if (fabs(a[p * n + q]) < 1e-300)
+						continue;
+
+					double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * a[p * n + q]);
+					double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+					double c = 1.0 / sqrt(t * t + 1.0);
+					double s = t * c;
+
+					for (int k = 0; k < n; ++k)
+					{
+						double akp = a[k * n + p], akq = a[k * n + q];
+						a[k * n + p] = c * akp - s * akq;
+						a[k * n + q] = s * akp + c * akq;
+					}
+					for (int k = 0; k < n; ++k)
+					{
+						double apk = a[p * n + k], aqk = a[q * n + k];
+						a[p * n + k] = c * apk - s * aqk;
+						a[q * n + k] = s * apk + c * aqk;
+					}
+					for (int k = 0; k < n; ++k)
+					{
+						double vkp = v[k * n + p], vkq = v[k * n + q];
+						v[k * n + p] = c * vkp - s * vkq;
+						v[k * n + q] = s * vkp + c * vkq;
+					}
+				}
+			}
+		}
+	}
+}
+
+void LowRankLut::init()
+{
+	m_rowTex = TextureHandle::create();
+	m_columnTex = TextureHandle::create();
+
+	for (GLuint tex : { m_rowTex.get(), m_columnTex.get() })
+	{
+		GLState::bindTexture(GL_TEXTURE_2D, tex);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	}
+	GLState::bindTexture(GL_TEXTURE_2D, 0);
+}
+
+void LowRankLut::factor(ThreadPool& pool, const std::vector<float>& table, int width, int height, int rank, int iterations)
+{
+	m_width = width;
+	m_height = height;
+	m_rank = glm::clamp(rank, 1, std::min(MAX_RANK, std::min(width, height)));
+	const int vectorCount = std::min(m_rank + OVERSAMPLING, std::min(width, height));
+
+	const int columnBlocks = (width + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+
+	// z = T q, one row of the table per task:
+	auto multiply = [&](const Vectors& q, Vectors& z)
+	{
+		pool.parallelFor(height, [&](int y)
+		{
+			const float* row = &table[(size_t)y * width];
+			for (int i = 0; i < vectorCount; ++i)
+			{
+				double sum = 0.0;
+				for (int x = 0; x < width; ++x)
+					sum += row[x] * q[i][x];
+				z[i][y] = sum;
+			}
+		});
+	};
+
+	// q = T^T z, one block of columns per task so no two tasks write the same entries:
+	auto multiplyTransposed = [&](const Vectors& z, Vectors& q)
+	{
+		pool.parallelFor(columnBlocks, [&](int block)
+		{
+			const int x0 = block * COLUMN_BLOCK;
+			const int x1 = std::min(x0 + COLUMN_BLOCK, width);
+			for (int i = 0; i < vectorCount; ++i)
+				std::fill(q[i].begin() + x0, q[i].begin() + x1, 0.0);
+
+			for (int y = 0; y < height; ++y)
+			{
+				const float* row = &table[(size_t)y * width];
+				for (int i = 0; i < vectorCount; ++i)
+				{
+					const double zi = z[i][y];
+					for (int x = x0; x < x1; ++x)
+						q[i][x] += row[x] * zi;
+				}
+			}
+		});
+	};
+
+	// Subspace iteration from a random start converges on the dominant right singular vectors:
+	std::mt19937 rng(1);
+	std::normal_distribution<double> normal;
+	Vectors q(vectorCount, std::vector<double>(width));
+	Vectors z(vectorCount, std::vector<double>(height));
+	for (std::vector<double>& vec : q)
+		for (double& x : vec)
+			x = normal(rng);
+	orthonormalise(q);
+
+	for (int iteration = 0; iteration < iterations; ++iteration)
+	{
+		multiply(q, z);
+		orthonormalise(z);
+		multiplyTransposed(z, q);
+		orthonormalise(q);
+	}
+	multiply(q, z);
+
+	// Rayleigh-Ritz: T ~= Z Q^T, and the eigenvectors W of Z^T Z rotate both into singular vectors, with
+	// the singular values the square roots of its eigenvalues:
+	std::vector<double> gram((size_t)vectorCount * vectorCount), w;
+	for (int i = 0; i < vectorCount; ++i)
+		for (int j = 0; j < vectorCount; ++j)
+			gram[i * vectorCount + j] = std::inner_product(z[i].begin(), z[i].end(), z[j].begin(), 0.0);
+	jacobiEigen(gram, w, vectorCount);
+
+	std::vector<int> order(vectorCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return gram[a * vectorCount + a] > gram[b * vectorCount + b]; });
+
+	m_rowFactors.assign(m_rank, std::vector<float>(height));
+	m_columnFactors.assign(m_rank, std::vector<float>(width));
+	m_singularValues.assign(m_rank, 0.0f);
+	for (int r = 0; r < m_rank; ++r)
+	{
+		const int e = order[r];
+		m_singularValues[r] = (float)sqrt(std::max(gram[e * vectorCount + e], 0.0));
+
+		// Row factor Z w (sigma * u), column factor Q w (v):
+		for (int y = 0; y < height; ++y)
+		{
+			double sum = 0.0;
+			for (int i = 0; i < vectorCount; ++i)
+				sum += z[i][y] * w[i * vectorCount + e];
+			m_rowFactors[r][y] = (float)sum;
+		}
+		for (int x = 0; x < width; ++x)
+		{
+			double sum = 0.0;
+			for (int i = 0; i < vectorCount; ++i)
+				sum += q[i][x] * w[i * vectorCount + e];
+			m_columnFactors[r][x] = (float)sum;
+		}
+	}
+}
+
+void LowRankLut::reconstruct(int rank, std::vector<float>& table) const
+{
+	rank = std::min(rank, m_rank);
+	table.assign((size_t)m_width * m_height, 0.0f);
+	for (int r = 0; r < rank; ++r)
+		for (int y = 0; y < m_height; ++y)
+			for (int x = 0; x < m_width; ++x)
+				table[(size_t)y * m_width + x] += m_rowFactors[r][y] * m_columnFactors[r][x];
+}
+
+void LowRankLut::upload()
+{
+	const int groups = getGroupCount();
+
+	auto pack = [&](const std::vector<std::vector<float>>& factors, int length, GLuint tex)
+	{
+		std::vector<glm::vec4> texels((size_t)length * groups, glm::vec4(0.0f));
+		for (int r = 0; r < m_rank; ++r)
+			for (int i = 0; i < length; ++i)
+				texels[(size_t)(r / 4) * length + i][r % 4] = factors[r][i];
+
+		GLState::bindTexture(GL_TEXTURE_2D, tex);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, length, groups, 0, GL_RGBA, GL_FLOAT, texels.data());
+	};
+	pack(m_rowFactors, m_height, m_rowTex);
+	pack(m_columnFactors, m_width, m_columnTex);
+	GLState::bindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Shader.h"
+#include "ThreadPool.h"
+#include <vector>
+
+// Scattering LUT compressed to a sum of rank-1 products, table(x, y) ~= sum_i row_i(y) * column_i(x),
+// from a truncated SVD. Smooth tables like Hoobler's need only a few ranks, turning a multi-megabyte
+// texture into two thin ones that stay in cache. Factors are packed four ranks per RGBA texel, one
+// texture row per group of four, so a lookup is one pair of fetches per group. Linear filtering of the
+// two factors gives exactly the bilinear filtering of the reconstructed table.
+class LowRankLut
+{
+public:
+	static const int MAX_RANK = 32;
+
+	LowRankLut() {};
+
+	void init();
+
+	// Truncated SVD of a width x height table, bottom row first, by subspace iteration across the pool:
+	void factor(ThreadPool& pool, const std::vector<float>& table, int width, int height, int rank, int iterations = 30);
+
+	// The table rebuilt from the first 'rank' components:
+	void reconstruct(int rank, std::vector<float>& table) const;
+
+	// Pack the factors into the row and column textures:
+	void upload();
+
+	bool isValid() const					{ return m_rank > 0; }
+	int getRank() const						{ return m_rank; }
+	int getGroupCount() const				{ return (m_rank + 3) / 4; }
+	float getSingularValue(int i) const		{ return m_singularValues[i]; }
+	unsigned int getRowTexture() const		{ return m_rowTex; }
+	unsigned int getColumnTexture() const	{ return m_columnTex; }
+	size_t getSizeBytes() const				{ return (size_t)(m_width + m_height) * getGroupCount() * 4 * sizeof(float); }
+
+private:
+	// Per rank: the row factor scaled by its singular value over the table's height, and the unit column
+	// factor over its width:
+	std::vector<std::vector<float>> m_rowFactors;
+	std::vector<std::vector<float>> m_columnFactors;
+	std::vector<float> m_singularValues;
+	int m_width{};
+	int m_height{};
+	int m_rank{};
+
+	TextureHandle m_rowTex;
+	TextureHandle m_columnTex;
+};
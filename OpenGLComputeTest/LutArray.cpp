@@ -0,0 +1,148 @@
+#include "LutArray.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const char CACHE_MAGIC[4] = { 'L', 'U', 'T', 'A' };
+	const uint32_t CACHE_VERSION = 1;
+
+	// Written ahead of the texels, which follow layer by layer, bottom row first:
+	struct CacheHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t format;
+		int32_t width, height, layers;
+		float gMin, gMax;
+		uint64_t key;
+	};
+}
+
+bool LutArray::Layout::operator==(const Layout& other) const
+{
+	return format == other.format && width == other.width && height == other.height && layers == other.layers
+		&& gMin == other.gMin && gMax == other.gMax && key == other.key;
+}
+
+void LutArray::init()
+{
+	m_tex = TextureHandle::create();
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_tex);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void LutArray::allocate(const Layout& layout)
+{
+	m_layout = layout;
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_tex);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, layout.format, layout.width, layout.height, layout.layers, 0,
+		getComponents() == 4 ? GL_RGBA : GL_RED, GL_FLOAT, NULL);
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+bool LutArray::load(const char* path, const Layout& layout)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	CacheHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+		|| header.version != CACHE_VERSION)
+	{
+		std::cout << "ERROR::LUT_ARRAY: " << path << " is not a LUT array cache" << std::endl;
+		return false;
+	}
+
+	Layout cached;
+	cached.format	= header.format;
+	cached.width	= header.width;
+	cached.height	= header.height;
+	cached.layers	= header.layers;
+	cached.gMin		= header.gMin;
+	cached.gMax		= header.gMax;
+	cached.key		= header.key;
+	if (cached != layout)
+		return false;
+
+	allocate(layout);
+	std::vector<float> texels((size_t)layout.width * layout.height * layout.layers * getComponents());
+	if (!file.read((char*)texels.data(), texels.size() * sizeof(float)))
+	{
+		std::cout << "ERROR::LUT_ARRAY: " << path << " is truncated" << std::endl;
+		m_layout = Layout();
+		return false;
+	}
+
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_tex);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, layout.width, layout.height, layout.layers,
+		getComponents() == 4 ? GL_RGBA : GL_RED, GL_FLOAT, texels.data());
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	return true;
+}
+
+bool LutArray::save(const char* path) const
+{
+	if (!isAllocated())
+		return false;
+
+	std::vector<float> texels((size_t)m_layout.width * m_layout.height * m_layout.layers * getComponents());
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_tex);
+	glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, getComponents() == 4 ? GL_RGBA : GL_RED, GL_FLOAT, texels.data());
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::LUT_ARRAY: Failed to open " << path << std::endl;
+		return false;
+	}
+
+	CacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version	= CACHE_VERSION;
+	header.format	= m_layout.format;
+	header.width	= m_layout.width;
+	header.height	= m_layout.height;
+	header.layers	= m_layout.layers;
+	header.gMin		= m_layout.gMin;
+	header.gMax		= m_layout.gMax;
+	header.key		= m_layout.key;
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)texels.data(), texels.size() * sizeof(float));
+	return (bool)file;
+}
+
+void LutArray::setUniforms(const Shader& shader) const
+{
+	shader.setInt("u_lutArrayLayers", m_layout.layers);
+	shader.setFloat("u_lutArrayGMin", m_layout.gMin);
+	shader.setFloat("u_lutArrayGMax", m_layout.gMax);
+}
+
+uint64_t LutArray::hash(const void* data, size_t size, uint64_t seed)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t h = seed;
+	for (size_t i = 0; i < size; ++i)
+		h = (h ^ bytes[i]) * 1099511628211ull;
+	return h;
+}
+
+size_t LutArray::getSizeBytes() const
+{
+	return (size_t)m_layout.width * m_layout.height * m_layout.layers * getComponents() * sizeof(float);
+}
+
+float LutArray::getG(int layer) const
+{
+	if (m_layout.layers < 2)
+		return m_layout.gMin;
+	return m_layout.gMin + (m_layout.gMax - m_layout.gMin) * layer / (m_layout.layers - 1);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Shader.h"
+#include <cstdint>
+
+// Slices of a scattering LUT baked over a range of Henyey-Greenstein g, held in one GL_TEXTURE_2D_ARRAY.
+// Lookups blend between the two slices around any g, so changing g at runtime costs a second fetch rather
+// than a rebake. Slices are baked straight into the array's layers by binding one layer at a time as an
+// image, and the whole array can be saved to and loaded from a disk cache.
+class LutArray
+{
+public:
+	// Everything a baked array depends on. 'key' hashes the bake's other parameters (see hash()), so a
+	// cache saved with different ones is rejected:
+	struct Layout
+	{
+		GLenum format = GL_R32F;	// GL_R32F or GL_RGBA32F.
+		int width{}, height{};
+		int layers{};
+		float gMin{}, gMax{};
+		uint64_t key{};
+
+		bool operator==(const Layout& other) const;
+		bool operator!=(const Layout& other) const	{ return !(*this == other); }
+	};
+
+	LutArray() {};
+
+	void init();
+
+	// Reallocate for 'layout', leaving every slice to be baked:
+	void allocate(const Layout& layout);
+
+	// Allocate and fill from a cache file, if it was saved with the same layout:
+	bool load(const char* path, const Layout& layout);
+	bool save(const char* path) const;
+
+	// Set u_lutArrayLayers, u_lutArrayGMin and u_lutArrayGMax:
+	void setUniforms(const Shader& shader) const;
+
+	// FNV-1a, for Layout::key:
+	static uint64_t hash(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+	bool isAllocated() const			{ return m_layout.layers > 0; }
+	const Layout& getLayout() const		{ return m_layout; }
+	unsigned int getTexture() const		{ return m_tex; }
+	size_t getSizeBytes() const;
+
+	// g baked into a layer, spaced evenly from gMin to gMax:
+	float getG(int layer) const;
+
+private:
+	int getComponents() const			{ return m_layout.format == GL_RGBA32F ? 4 : 1; }
+
+	Layout m_layout;
+	TextureHandle m_tex;
+};
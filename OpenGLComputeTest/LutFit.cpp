@@ -0,0 +1,152 @@
+#include "LutFit.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Solve the normal equations in place with partial pivoting. A tiny ridge keeps bands whose samples
+	// don't pin down every coefficient (e.g. a single row with degreeV > 0) solvable:
+	void solve(std::vector<double>& a, std::vector<double>& b, int n)
+	{
+		double trace = 0.0;
+		for (int i = 0; i < n; ++i)
+			trace += a[i * n + i];
+		for (int i = 0; i < n; ++i)
+			a[i * n + i] += trace * 1e-12 + 1e-30;
+
+		for (int col = 0; col < n; ++col)
+		{
+			int pivot = col;
+			for (int row = col + 1; row < n; ++row)
+				if (fabs(a[row * n + col]) > fabs(a[pivot * n + col]))
+					pivot = row;
+			if (pivot != col)
+			{
+				for (int i = 0; i < n; ++i)
+					std::swap(a[col * n + i], a[pivot * n + i]);
+				std::swap(b[col], b[pivot]);
+			}
+
+			for (int row = col + 1; row < n; ++row)
+			{
+				double factor = a[row * n + col] / a[col * n + col];
+				for (int i = col; i < n; ++i)
+					a[row * n + i] -= factor * a[col * n + i];
+				b[row] -= factor * b[col];
+			}
+		}
+
+		for (int row = n - 1; row >= 0; --row)
+		{
+			double sum = b[row];
+			for (int i = row + 1; i < n; ++i)
+				sum -= a[row * n + i] * b[i];
+			b[row] = sum / a[row * n + row];
+		}
+	}
+}
+
+void LutFit::init()
+{
+	m_fitBuffer = BufferHandle::create();
+	upload();
+}
+
+void LutFit::fit(ThreadPool& pool, const std::vector<float>& table, int width, int height, int bands, int degreeU, int degreeV)
+{
+	m_bands = glm::clamp(bands, 1, height);
+	m_degreeU = glm::clamp(degreeU, 0, MAX_DEGREE);
+	m_degreeV = glm::clamp(degreeV, 0, MAX_DEGREE);
+
+	const int termsU = m_degreeU + 1;
+	const int terms = termsU * (m_degreeV + 1);
+	m_coefficients.assign((size_t)m_bands * terms, 0.0f);
+
+	pool.parallelFor(m_bands, [&](int band)
+	{
+		std::vector<double> ata((size_t)terms * terms, 0.0);
+		std::vector<double> atb(terms, 0.0);
+		std::vector<double> basis(terms);
+		std::vector<double> powersU(termsU);
+
+		// Accumulate the normal equations over the rows whose centres fall in this band:
+		for (int y = 0; y < height; ++y)
+		{
+			double v = (y + 0.5) / height * m_bands;
+			if (std::min((int)v, m_bands - 1) != band)
+				continue;
+			double by = 2.0 * (v - band) - 1.0;
+
+			for (int x = 0; x < width; ++x)
+			{
+				double bx = 2.0 * (x + 0.5) / width - 1.0;
+				powersU[0] = 1.0;
+				for (int i = 1; i < termsU; ++i)
+					powersU[i] = powersU[i - 1] * bx;
+
+				double powerV = 1.0;
+				for (int j = 0; j <= m_degreeV; ++j, powerV *= by)
+					for (int i = 0; i < termsU; ++i)
+						basis[j * termsU + i] = powersU[i] * powerV;
+
+				const double value = table[(size_t)y * width + x];
+				for (int r = 0; r < terms; ++r)
+				{
+					atb[r] += basis[r] * value;
+					for (int c = 0; c < terms; ++c)
+						ata[(size_t)r * terms + c] += basis[r] * basis[c];
+				}
+			}
+		}
+
+		solve(ata, atb, terms);
+		for (int i = 0; i < terms; ++i)
+			m_coefficients[(size_t)band * terms + i] = (float)atb[i];
+	});
+}
+
+float LutFit::evaluate(float u, float v) const
+{
+	if (m_coefficients.empty())
+		return 0.0f;
+
+	const int termsU = m_degreeU + 1;
+	float bandCoord = glm::clamp(v, 0.0f, 1.0f) * m_bands;
+	int band = std::min((int)bandCoord, m_bands - 1);
+	float x = 2.0f * glm::clamp(u, 0.0f, 1.0f) - 1.0f;
+	float y = 2.0f * (bandCoord - band) - 1.0f;
+
+	// Horner's rule in v over polynomials in u:
+	const float* c = &m_coefficients[(size_t)band * termsU * (m_degreeV + 1)];
+	float result = 0.0f;
+	for (int j = m_degreeV; j >= 0; --j)
+	{
+		float row = 0.0f;
+		for (int i = m_degreeU; i >= 0; --i)
+			row = row * x + c[j * termsU + i];
+		result = result * y + row;
+	}
+	return result;
+}
+
+void LutFit::evaluateTable(int width, int height, std::vector<float>& table) const
+{
+	table.resize((size_t)width * height);
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			table[(size_t)y * width + x] = evaluate((x + 0.5f) / width, (y + 0.5f) / height);
+}
+
+void LutFit::upload()
+{
+	// Keep the buffer non-empty so it can always be bound:
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_fitBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(getSizeBytes(), sizeof(float)), NULL, GL_STATIC_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, getSizeBytes(), m_coefficients.data());
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void LutFit::bind() const
+{
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, FIT_BINDING, m_fitBuffer);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Shader.h"
+#include "ThreadPool.h"
+#include <vector>
+
+// Closed-form stand-in for a scattering LUT. The table's rows are split into bands, and each band gets a
+// least-squares polynomial in u and v (both remapped to [-1, 1] across the band), so the fog can evaluate
+// a few hundred coefficients from an SSBO instead of sampling a multi-megabyte texture. Trades the LUT's
+// bandwidth for ALU, and its accuracy for size: bands around sharp features (Hoobler's rows near the
+// light) fit worst.
+class LutFit
+{
+public:
+	static const int FIT_BINDING = 7;
+	static const int MAX_DEGREE = 8;
+
+	LutFit() {};
+
+	void init();
+
+	// Fit a width x height table, bottom row first, sampled at texel centres. Bands are fitted in parallel:
+	void fit(ThreadPool& pool, const std::vector<float>& table, int width, int height, int bands, int degreeU, int degreeV);
+
+	// CPU mirror of EvaluateFit() in froxelInjectShader.comp:
+	float evaluate(float u, float v) const;
+
+	// Evaluate the fit at the texel centres of a width x height table:
+	void evaluateTable(int width, int height, std::vector<float>& table) const;
+
+	void upload();
+	void bind() const;
+
+	bool isValid() const			{ return !m_coefficients.empty(); }
+	int getBands() const			{ return m_bands; }
+	int getDegreeU() const			{ return m_degreeU; }
+	int getDegreeV() const			{ return m_degreeV; }
+	size_t getSizeBytes() const		{ return m_coefficients.size() * sizeof(float); }
+
+private:
+	// Per band, (degreeU + 1) * (degreeV + 1) coefficients with the u power varying fastest:
+	std::vector<float> m_coefficients;
+	int m_bands{};
+	int m_degreeU{};
+	int m_degreeV{};
+
+	BufferHandle m_fitBuffer;
+};
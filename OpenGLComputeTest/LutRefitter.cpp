@@ -0,0 +1,149 @@
+#include "LutRefitter.h"
+#include "ScatteringReference.h"
+#include <iostream>
+#include <memory>
+
+LutRefitter::~LutRefitter()
+{
+	// The job writes into the slots and decodes out of the mapped pack buffer:
+	if (m_job.valid())
+		m_job.wait();
+}
+
+void LutRefitter::init()
+{
+	for (LutFit (&pair)[2] : m_fits)
+		for (LutFit& fit : pair)
+			fit.init();
+	for (LowRankLut& lowRank : m_lowRanks)
+		lowRank.init();
+}
+
+bool LutRefitter::isRefitDue(Target target, uint64_t key, bool force) const
+{
+	const Slot& slot = m_slots[(int)target];
+	if (isBusy())
+		return false;
+	if (slot.live < 0 || force)
+		return true;
+	return slot.key != key && std::chrono::steady_clock::now() - m_lastStart >= std::chrono::duration<float>(m_interval);
+}
+
+void LutRefitter::refit(Target target, uint64_t key, GLuint lutTex, glm::ivec2 size, glm::ivec2 region, const Settings& settings)
+{
+	if (isBusy())
+		return;
+
+	m_target = target;
+	m_key = key;
+	m_size = size;
+	m_region = region;
+	m_settings = settings;
+	m_spare = m_slots[(int)target].live == 0 ? 1 : 0;
+	m_lastStart = std::chrono::steady_clock::now();
+
+	// Mapped for reading once the copy lands, so never immutable storage:
+	const GLsizeiptr bytes = (GLsizeiptr)size.x * size.y * sizeof(glm::vec4);
+	if (m_readback.getSize() != bytes)
+		m_readback.allocate<glm::vec4>(GL_PIXEL_PACK_BUFFER, (size_t)size.x * size.y, Buffer::Usage::STREAM);
+
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	m_readback.bind();
+	GLState::bindTexture(GL_TEXTURE_2D, lutTex);
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, (void*)0);
+	m_fence.reset(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	// Left bound, it would turn every other glGetTexImage() pointer into a buffer offset:
+	GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	m_stage = Stage::READING_BACK;
+}
+
+bool LutRefitter::update()
+{
+	if (m_stage == Stage::READING_BACK)
+	{
+		const GLenum status = glClientWaitSync(m_fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			return false;
+		m_fence.reset();
+
+		// Stays mapped until the job is done with it:
+		m_readback.bind();
+		const glm::vec4* texels = (const glm::vec4*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_readback.getSize(), GL_MAP_READ_BIT);
+		GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if (!texels)
+		{
+			std::cout << "ERROR::LUT_REFITTER: Failed to map the LUT readback" << std::endl;
+			m_stage = Stage::IDLE;
+			return false;
+		}
+
+		std::shared_ptr<std::packaged_task<void()>> job = std::make_shared<std::packaged_task<void()>>([this, texels] { runJob(texels); });
+		m_job = job->get_future();
+		m_jobPool.submit([job] { (*job)(); });
+		m_stage = Stage::FITTING;
+		return false;
+	}
+
+	if (m_stage != Stage::FITTING || m_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return false;
+	m_job.get();
+
+	m_readback.bind();
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	Slot& slot = m_slots[(int)m_target];
+	if (m_target == Target::HOOBLER_LOW_RANK)
+		m_lowRanks[m_spare].upload();
+	else
+		m_fits[(int)m_target][m_spare].upload();
+	slot.live = m_spare;
+	slot.key = m_key;
+	m_rmse = m_jobRmse;
+	m_maxError = m_jobMaxError;
+	m_stage = Stage::IDLE;
+	return true;
+}
+
+const LutFit* LutRefitter::getFit(Target target) const
+{
+	const Slot& slot = m_slots[(int)target];
+	return slot.live >= 0 ? &m_fits[(int)target][slot.live] : nullptr;
+}
+
+const LowRankLut* LutRefitter::getLowRank() const
+{
+	const Slot& slot = m_slots[(int)Target::HOOBLER_LOW_RANK];
+	return slot.live >= 0 ? &m_lowRanks[slot.live] : nullptr;
+}
+
+void LutRefitter::runJob(const glm::vec4* texels)
+{
+	// Hoobler's summed LUT is stored divided by the scale in A:
+	const bool hoobler = m_target != Target::KOVALOVS_FIT;
+	std::vector<float> table((size_t)m_region.x * m_region.y);
+	for (int y = 0; y < m_region.y; ++y)
+	{
+		for (int x = 0; x < m_region.x; ++x)
+		{
+			const glm::vec4& s = texels[(size_t)y * m_size.x + x];
+			table[(size_t)y * m_region.x + x] = hoobler ? s.r * s.a : s.r;
+		}
+	}
+
+	std::vector<float> approximation;
+	if (m_target == Target::HOOBLER_LOW_RANK)
+	{
+		LowRankLut& lowRank = m_lowRanks[m_spare];
+		lowRank.factor(m_fitPool, table, m_region.x, m_region.y, m_settings.lowRank);
+		lowRank.reconstruct(m_settings.lowRank, approximation);
+	}
+	else
+	{
+		LutFit& fit = m_fits[(int)m_target][m_spare];
+		fit.fit(m_fitPool, table, m_region.x, m_region.y, m_settings.fitBands, m_settings.fitDegreeU, m_settings.fitDegreeV);
+		fit.evaluateTable(m_region.x, m_region.y, approximation);
+	}
+	ScatteringReference::compare(approximation, table, m_jobRmse, m_jobMaxError);
+}
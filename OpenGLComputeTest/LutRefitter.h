@@ -0,0 +1,111 @@
+#pragma once
+#include "Buffer.h"
+#include "LowRankLut.h"
+#include "LutFit.h"
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <glm/glm.hpp>
+
+// Keeps the polynomial fits and low-rank factors standing in for the scattering LUTs up to date without
+// stalling the frame loop. A refit reads the LUT back into a pixel pack buffer behind a fence, and once
+// the copy has landed decodes and fits (or factors) it on the job pool, into the spare of a pair. The one
+// in use is only swapped for it once the job is done, and refits start at most once an interval, so a LUT
+// that changes every frame (Hoobler's follows the camera) costs one background refit per interval rather
+// than a readback and fit per frame.
+// Like TextureLoader, give the jobs a pool other than the one fits spread across: ThreadPool::wait(), and
+// so parallelFor(), waits for every task on the pool, the job included.
+class LutRefitter
+{
+public:
+	enum class Target
+	{
+		KOVALOVS_FIT,
+		HOOBLER_FIT,
+		HOOBLER_LOW_RANK
+	};
+
+	struct Settings
+	{
+		int fitBands{};
+		int fitDegreeU{};
+		int fitDegreeV{};
+		int lowRank{};
+	};
+
+	static const int TARGET_COUNT = 3;
+	static constexpr float DEFAULT_INTERVAL = 0.5f;
+
+	LutRefitter(ThreadPool& jobPool, ThreadPool& fitPool) : m_jobPool(jobPool), m_fitPool(fitPool) {};
+	~LutRefitter();
+
+	LutRefitter(const LutRefitter&) = delete;
+	LutRefitter& operator=(const LutRefitter&) = delete;
+
+	void init();
+
+	// Whether to start a refit of 'target' from a LUT baked with 'key' this frame. Never while another is
+	// in flight, and after the first only once the interval has passed since the last started. 'force'
+	// refits an unchanged LUT, straight away:
+	bool isRefitDue(Target target, uint64_t key, bool force) const;
+
+	// Start reading back the region of a LUT 'size' texels in size, baked this frame with 'key':
+	void refit(Target target, uint64_t key, GLuint lutTex, glm::ivec2 size, glm::ivec2 region, const Settings& settings);
+
+	// On the render thread, once a frame: hands a landed readback to the job pool and swaps in a finished
+	// refit. Returns true when one was swapped in:
+	bool update();
+
+	// The fit or factors in use, or null until the first refit of them is done:
+	const LutFit* getFit(Target target) const;
+	const LowRankLut* getLowRank() const;
+
+	bool isBusy() const						{ return m_stage != Stage::IDLE; }
+	void setInterval(float seconds)			{ m_interval = seconds; }
+
+	// Of the last refit swapped in, against the LUT it was made from:
+	float getRmse() const					{ return m_rmse; }
+	float getMaxError() const				{ return m_maxError; }
+
+private:
+	enum class Stage
+	{
+		IDLE,
+		READING_BACK,	// Waiting on the fence after the copy into the pack buffer.
+		FITTING			// Job running, the pack buffer mapped for it to decode from.
+	};
+
+	struct Slot
+	{
+		int live = -1;		// Which of the target's pair is in use, -1 until the first refit is done.
+		uint64_t key{};		// Key of the LUT the one in use was made from.
+	};
+
+	// On the job pool, out of the mapped pack buffer into the spare of the target's pair:
+	void runJob(const glm::vec4* texels);
+
+	ThreadPool& m_jobPool;
+	ThreadPool& m_fitPool;
+
+	Slot m_slots[TARGET_COUNT];
+	LutFit m_fits[2][2];			// A pair per fit target.
+	LowRankLut m_lowRanks[2];
+	float m_interval = DEFAULT_INTERVAL;
+	std::chrono::steady_clock::time_point m_lastStart{};
+	float m_rmse{};
+	float m_maxError{};
+
+	// The refit in flight. Only the job touches the spare and m_job* until it is done:
+	Stage m_stage = Stage::IDLE;
+	Target m_target{};
+	uint64_t m_key{};
+	glm::ivec2 m_size{};
+	glm::ivec2 m_region{};
+	Settings m_settings{};
+	int m_spare{};
+	Buffer m_readback;
+	SyncHandle m_fence;
+	std::future<void> m_job;
+	float m_jobRmse{};
+	float m_jobMaxError{};
+};
@@ -0,0 +1,60 @@
+#include "LutWarp.h"
+#include <cmath>
+
+namespace
+{
+	const float PI = 3.14159265358979f;
+
+	float phaseCdf(float mu, float g)
+	{
+		if (fabsf(g) < 1e-3f)
+			return 0.5f * (mu + 1.0f);
+		return (1.0f - g * g) / (2.0f * g) * (1.0f / sqrtf(1.0f + g * g - 2.0f * g * mu) - 1.0f / (1.0f + g));
+	}
+
+	float phaseInverseCdf(float xi, float g)
+	{
+		if (fabsf(g) < 1e-3f)
+			return 2.0f * xi - 1.0f;
+		float s = (1.0f - g * g) / (1.0f - g + 2.0f * g * xi);
+		return (1.0f + g * g - s * s) / (2.0f * g);
+	}
+}
+
+float AxisWarp::encode(float x) const
+{
+	x = glm::clamp(x, 0.0f, 1.0f);
+	switch (type)
+	{
+		case Type::POWER:
+			return powf(x, 1.0f / param);
+		case Type::LOG:
+			return logf(1.0f + x * (expf(param) - 1.0f)) / param;
+		case Type::PHASE_CDF:
+			return 1.0f - phaseCdf(cosf(x * PI), param);
+		default:
+			return x;
+	}
+}
+
+float AxisWarp::decode(float u) const
+{
+	u = glm::clamp(u, 0.0f, 1.0f);
+	switch (type)
+	{
+		case Type::POWER:
+			return powf(u, param);
+		case Type::LOG:
+			return (expf(param * u) - 1.0f) / (expf(param) - 1.0f);
+		case Type::PHASE_CDF:
+			return acosf(glm::clamp(phaseInverseCdf(1.0f - u, param), -1.0f, 1.0f)) / PI;
+		default:
+			return u;
+	}
+}
+
+void AxisWarp::setUniforms(const Shader& shader, const std::string& prefix) const
+{
+	shader.setInt(prefix + "Warp", (int)type);
+	shader.setFloat(prefix + "WarpParam", param);
+}
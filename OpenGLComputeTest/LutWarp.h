@@ -0,0 +1,24 @@
+#pragma once
+#include "Shader.h"
+
+// Non-uniform mapping of a LUT axis, from a value normalised to [0, 1] to a texture coordinate and back.
+// Mirrors res/lutWarp.glsl, which the LUT bakes and the fog share, so tools that bake or sample LUTs on
+// the CPU agree with them.
+struct AxisWarp
+{
+	enum class Type {
+		LINEAR,
+		POWER,		// Param is the exponent, > 1 for more texels near 0.
+		LOG,		// Param is the steepness, > 0 for more texels near 0.
+		PHASE_CDF	// Angle axes (angle / pi). Param is the g of the HG phase whose CDF spaces the texels.
+	};
+
+	Type type = Type::LINEAR;
+	float param = 1.0f;
+
+	float encode(float x) const;
+	float decode(float u) const;
+
+	// Set '<prefix>Warp' and '<prefix>WarpParam':
+	void setUniforms(const Shader& shader, const std::string& prefix) const;
+};
@@ -0,0 +1,106 @@
+#include "MipGenerator.h"
+#include <algorithm>
+
+void MipGenerator::init()
+{
+	// Every destination level needs its own image unit:
+	int imageUniforms;
+	glGetIntegerv(GL_MAX_COMPUTE_IMAGE_UNIFORMS, &imageUniforms);
+	m_maxLevelsPerDispatch = std::min(imageUniforms, 16);
+
+	// Group counter for the last-group reduction, reset by the shader once it is done:
+	const unsigned int zero = 0;
+	m_counterBuffer = BufferHandle::create();
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_counterBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(zero), &zero, GL_DYNAMIC_COPY);
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void MipGenerator::generate2D(unsigned int texture, unsigned int internalFormat, int width, int height, Filter filter)
+{
+	generate(GL_TEXTURE_2D, texture, internalFormat, width, height, 1, filter);
+}
+
+void MipGenerator::generate3D(unsigned int texture, unsigned int internalFormat, int width, int height, int depth, Filter filter)
+{
+	generate(GL_TEXTURE_3D, texture, internalFormat, width, height, depth, filter);
+}
+
+int MipGenerator::getLevelCount(int width, int height, int depth)
+{
+	int levels = 1;
+	for (int size = std::max(width, std::max(height, depth)); size > 1; size >>= 1)
+		++levels;
+	return levels;
+}
+
+void MipGenerator::generate(unsigned int target, unsigned int texture, unsigned int internalFormat, int width, int height, int depth, Filter filter)
+{
+	const int levelCount = getLevelCount(width, height, target == GL_TEXTURE_3D ? depth : 1);
+	if (levelCount < 2)
+		return;
+
+	Shader& shader = getShader(target, internalFormat);
+	shader.use();
+	shader.setInt("u_source", 0);
+	shader.setInt("u_filter", (int)filter);
+
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(target, texture);
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_counterBuffer);
+
+	// Level 0 may have just been written through an image:
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+	for (int baseLevel = 0; baseLevel < levelCount - 1; baseLevel += m_maxLevelsPerDispatch)
+	{
+		const int count = std::min(m_maxLevelsPerDispatch, levelCount - 1 - baseLevel);
+		const bool layered = target == GL_TEXTURE_3D;
+
+		for (int i = 0; i < count; ++i)
+			GLState::bindImageTexture(i, texture, baseLevel + 1 + i, layered, 0, GL_WRITE_ONLY, internalFormat);
+
+		shader.setInt("u_baseLevel", baseLevel);
+		shader.setInt("u_levelCount", count);
+
+		// One invocation per texel of the first destination level:
+		const int w = std::max(1, width >> (baseLevel + 1));
+		const int h = std::max(1, height >> (baseLevel + 1));
+		const int d = std::max(1, depth >> (baseLevel + 1));
+
+		if (layered)
+			glDispatchCompute((w + 7) / 8, (h + 7) / 8, (d + 7) / 8);
+		else
+			glDispatchCompute((w + 15) / 16, (h + 15) / 16, 1);
+
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	}
+}
+
+Shader& MipGenerator::getShader(unsigned int target, unsigned int internalFormat)
+{
+	auto key = std::make_pair(target, internalFormat);
+	auto it = m_shaders.find(key);
+	if (it != m_shaders.end())
+		return it->second;
+
+	std::string format;
+	switch (internalFormat)
+	{
+	case GL_RGBA32F:	format = "rgba32f";	break;
+	case GL_RGBA16F:	format = "rgba16f";	break;
+	case GL_R32F:		format = "r32f";	break;
+	case GL_R16F:		format = "r16f";	break;
+	default:
+		std::cout << "MIP GENERATOR: UNSUPPORTED INTERNAL FORMAT (" << internalFormat << ")" << std::endl;
+		format = "rgba32f";
+		break;
+	}
+
+	std::string defines =	"#define IMAGE_FORMAT " + format + "\n" +
+							"#define MIP_LEVELS " + std::to_string(m_maxLevelsPerDispatch) + "\n";
+
+	Shader& shader = m_shaders[key];
+	shader.loadShader(target == GL_TEXTURE_3D ? "res/mipDownsample3DShader.comp" : "res/mipDownsample2DShader.comp", defines);
+	return shader;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Shader.h"
+#include <map>
+
+// Builds the mip chain of a 2D or 3D float texture on the GPU. Each group reduces a tile of the base level
+// through shared memory, and the last group to finish reduces the remaining levels, so the whole chain is
+// built in one dispatch as long as enough image units are available (otherwise it is split into as few
+// dispatches as the limit allows). Textures need immutable storage with all levels allocated.
+class MipGenerator
+{
+public:
+	enum class Filter {
+		BOX,
+		MAX,
+		MIN
+	};
+
+	MipGenerator() {};
+
+	void init();
+
+	void generate2D(unsigned int texture, unsigned int internalFormat, int width, int height, Filter filter = Filter::BOX);
+	void generate3D(unsigned int texture, unsigned int internalFormat, int width, int height, int depth, Filter filter = Filter::BOX);
+
+	// Number of levels in a full chain down to 1x1(x1):
+	static int getLevelCount(int width, int height, int depth = 1);
+
+private:
+	void generate(unsigned int target, unsigned int texture, unsigned int internalFormat, int width, int height, int depth, Filter filter);
+	Shader& getShader(unsigned int target, unsigned int internalFormat);
+
+	// Compiled variants, keyed by texture target and internal format:
+	std::map<std::pair<unsigned int, unsigned int>, Shader> m_shaders;
+	BufferHandle m_counterBuffer;
+	int m_maxLevelsPerDispatch{};
+};
@@ -0,0 +1,72 @@
+#include "NoiseVolume.h"
+#include "MipGenerator.h"
+#include <cmath>
+
+void NoiseVolume::init(int width, int height, int depth)
+{
+	m_width = width;
+	m_height = height;
+	m_depth = depth;
+
+	m_shader.loadShader("res/noise3DComputeShader.comp");
+
+	// Repeat along R so samples that cross the ring's wrap point stay continuous:
+	m_texture = TextureHandle::create();
+	GLState::bindTexture(GL_TEXTURE_3D, m_texture);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexStorage3D(GL_TEXTURE_3D, MipGenerator::getLevelCount(width, height, depth), GL_RGBA32F, width, height, depth);
+	GLState::bindTexture(GL_TEXTURE_3D, 0);
+}
+
+void NoiseVolume::generateFull(float freq, float time)
+{
+	dispatchSlices(0, m_depth, freq, time);
+	m_slicesGenerated = m_depth;
+	m_ringOffset = 0.0f;
+
+	// Contents no longer match the ring, so the next incremental update has to refill it:
+	m_headSlice = -1;
+}
+
+void NoiseVolume::generateIncremental(float freq, float scrollSpeed, float time)
+{
+	// Current scroll position in slices, i.e. how far the oldest visible slice has moved along z:
+	const float position = scrollSpeed * time / freq;
+	const int newHead = (int)floorf(position);
+
+	m_slicesGenerated = 0;
+	m_ringOffset = position;
+
+	if (m_headSlice < 0 || freq != m_ringFreq || newHead < m_headSlice || newHead - m_headSlice >= m_depth)
+	{
+		// Nothing in the ring can be reused, so fill every slot:
+		dispatchSlices(newHead, m_depth, freq, 0.0f);
+		m_slicesGenerated = m_depth;
+	}
+	else if (newHead > m_headSlice)
+	{
+		// Slices [oldHead + depth, newHead + depth) have scrolled in and overwrite the ones that left:
+		const int count = newHead - m_headSlice;
+		dispatchSlices(m_headSlice + m_depth, count, freq, 0.0f);
+		m_slicesGenerated = count;
+	}
+
+	m_headSlice = newHead;
+	m_ringFreq = freq;
+}
+
+void NoiseVolume::dispatchSlices(int firstSlice, int count, float freq, float time)
+{
+	m_shader.use();
+	m_shader.setFloat("u_freq", freq);
+	m_shader.setFloat("u_time", time);
+	m_shader.setInt("u_firstSlice", firstSlice);
+	m_shader.setInt("u_sliceCount", count);
+
+	GLState::bindImageTexture(1, m_texture, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+	glDispatchCompute((m_width + 7) / 8, (m_height + 7) / 8, count);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Shader.h"
+
+// 3D Perlin noise volume generated by noise3DComputeShader.comp. Time can either be applied as an offset
+// to every texel (full regeneration each frame) or treated as a scrolling axis along z, in which case
+// the texture is a ring of slices and only the slices that scroll in at the leading edge are generated.
+class NoiseVolume
+{
+public:
+	NoiseVolume() {};
+
+	void init(int width, int height, int depth);
+
+	// Re-evaluate every slice with time added to the z coordinate:
+	void generateFull(float freq, float time);
+
+	// Scroll along z by 'scrollSpeed' noise units per second and only generate the slices that are new
+	// since the last call. Falls back to a full ring refill if the frequency changes or the ring is
+	// overtaken in a single frame:
+	void generateIncremental(float freq, float scrollSpeed, float time);
+
+	unsigned int getTexture() const		{ return m_texture; }
+	int getDepth() const				{ return m_depth; }
+	int getSlicesGenerated() const		{ return m_slicesGenerated; }
+
+	// Position of the oldest valid slice, in slices (fractional part included). Samplers take a normalised
+	// depth w to the position p = min(offset + w * (depth - 1), floor(offset) + depth - 1), then to the
+	// ring with (mod(floor(p), depth) + fract(p) + 0.5) / depth and GL_REPEAT on R:
+	float getRingOffset() const			{ return m_ringOffset; }
+
+private:
+	void dispatchSlices(int firstSlice, int count, float freq, float time);
+
+	Shader m_shader;
+	TextureHandle m_texture;
+	int m_width{}, m_height{}, m_depth{};
+
+	// Ring state. m_headSlice is the oldest slice stored, so the ring holds [head, head + depth):
+	int m_headSlice = -1;
+	float m_ringFreq{};
+	float m_ringOffset{};
+	int m_slicesGenerated{};
+};
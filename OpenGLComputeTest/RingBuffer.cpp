@@ -0,0 +1,90 @@
+#include "RingBuffer.h"
+#include <algorithm>
+#include <iostream>
+
+bool RingBuffer::init(GLsizeiptr frameSize)
+{
+	// Buffer only maps persistently through DSA:
+	if (!GLDsa::isAvailable())
+		return false;
+
+	GLint uniformAlignment = 256, storageAlignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	m_uniformAlignment = uniformAlignment;
+	m_storageAlignment = storageAlignment;
+
+	// Regions start aligned for anything allocated from them:
+	const GLsizeiptr alignment = std::max<GLsizeiptr>(256, std::max(m_uniformAlignment, m_storageAlignment));
+	m_frameSize = (frameSize + alignment - 1) / alignment * alignment;
+
+	m_buffer.allocate<char>(GL_UNIFORM_BUFFER, (size_t)m_frameSize * FRAME_COUNT, Buffer::Usage::PERSISTENT);
+	m_mapped = (char*)m_buffer.getMapped();
+	m_region = 0;
+	m_head = 0;
+	return m_mapped != nullptr;
+}
+
+void RingBuffer::beginFrame()
+{
+	m_region = (m_region + 1) % FRAME_COUNT;
+	m_head = m_region * m_frameSize;
+	m_overflowReported = false;
+
+	SyncHandle& fence = m_fences[m_region];
+	if (!fence)
+		return;
+
+	// Normally signalled long ago. If not, flush so the wait can end:
+	GLenum status = glClientWaitSync(fence, 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED)
+	{
+		++m_stalls;
+		do
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		while (status == GL_TIMEOUT_EXPIRED);
+	}
+	fence.reset();
+}
+
+void RingBuffer::endFrame()
+{
+	if (m_mapped)
+		m_fences[m_region].reset(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+RingBuffer::Allocation RingBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment)
+{
+	// Counted like an overflow, so the fallback shows up:
+	if (!m_mapped)
+	{
+		++m_overflows;
+		return Allocation();
+	}
+
+	const GLsizeiptr offset = (m_head + alignment - 1) / alignment * alignment;
+	const GLsizeiptr regionEnd = (m_region + 1) * m_frameSize;
+	if (offset + size > regionEnd)
+	{
+		++m_overflows;
+		if (!m_overflowReported)
+			std::cout << "ERROR::RING_BUFFER: " << size << " bytes don't fit in what's left of the " << m_frameSize << " byte frame region" << std::endl;
+		m_overflowReported = true;
+		return Allocation();
+	}
+
+	m_head = offset + size;
+	m_peakUsed = std::max(m_peakUsed, getUsed());
+
+	Allocation allocation;
+	allocation.data = m_mapped + offset;
+	allocation.buffer = m_buffer.get();
+	allocation.offset = offset;
+	allocation.size = size;
+	return allocation;
+}
+
+void RingBuffer::bindRange(GLenum target, GLuint index, const Allocation& allocation)
+{
+	GLState::bindBufferRange(target, index, allocation.buffer, allocation.offset, allocation.size);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "Buffer.h"
+#include <cstring>
+
+// Per-frame uniform, storage and indirect data, sub-allocated from one persistently mapped, coherent
+// buffer split into FRAME_COUNT regions. A frame writes only its own region, and a fence issued at the
+// end of the frame guards it, so by the time the ring comes back round the GPU is normally done with it
+// and an upload is a plain memcpy with no driver synchronisation. Allocations that don't fit in what's
+// left of the frame's region come back empty and are counted as overflows; so does everything while
+// persistent mapping isn't available (no GL 4.5 DSA), so callers keep a fallback.
+class RingBuffer
+{
+public:
+	static const int FRAME_COUNT = 3;
+
+	struct Allocation
+	{
+		void* data{};		// Null when the allocation failed.
+		GLuint buffer{};
+		GLintptr offset{};
+		GLsizeiptr size{};
+	};
+
+	RingBuffer() {};
+
+	// 'frameSize' bytes per region. Returns false if persistent mapping isn't available:
+	bool init(GLsizeiptr frameSize);
+
+	// Start writing the next region, waiting on its fence if the GPU is somehow still reading it:
+	void beginFrame();
+
+	// Fence the frame's region once everything reading it has been submitted:
+	void endFrame();
+
+	Allocation allocate(GLsizeiptr size, GLsizeiptr alignment);
+	Allocation allocateUniform(GLsizeiptr size)		{ return allocate(size, m_uniformAlignment); }
+	Allocation allocateStorage(GLsizeiptr size)		{ return allocate(size, m_storageAlignment); }
+	Allocation allocateIndirect(GLsizeiptr size)	{ return allocate(size, 4); }
+
+	// Allocate and copy in one go:
+	template <typename T>
+	Allocation pushUniform(const T& value)
+	{
+		Allocation allocation = allocateUniform(sizeof(T));
+		if (allocation.data)
+			memcpy(allocation.data, &value, sizeof(T));
+		return allocation;
+	}
+
+	// For uniform or storage blocks. Indirect data is bound to GL_DISPATCH_INDIRECT_BUFFER or
+	// GL_DRAW_INDIRECT_BUFFER and addressed by the allocation's offset:
+	static void bindRange(GLenum target, GLuint index, const Allocation& allocation);
+
+	bool isAvailable() const			{ return m_mapped != nullptr; }
+	GLsizeiptr getFrameSize() const		{ return m_frameSize; }
+	GLsizeiptr getUsed() const			{ return m_head - m_region * m_frameSize; }
+	GLsizeiptr getPeakUsed() const		{ return m_peakUsed; }
+	unsigned int getOverflowCount() const	{ return m_overflows; }
+	unsigned int getStallCount() const	{ return m_stalls; }
+
+private:
+	Buffer m_buffer;
+	char* m_mapped{};
+	GLsizeiptr m_frameSize{};
+	GLsizeiptr m_uniformAlignment = 256;
+	GLsizeiptr m_storageAlignment = 256;
+
+	SyncHandle m_fences[FRAME_COUNT];
+	int m_region{};
+	GLsizeiptr m_head{};			// Next free byte, within the current region.
+	GLsizeiptr m_peakUsed{};
+	unsigned int m_overflows{};
+	unsigned int m_stalls{};		// Frames that had to wait for the GPU to release their region.
+	bool m_overflowReported{};
+};
@@ -0,0 +1,176 @@
+#include "ScatteringReference.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const double PI = 3.141592653589793238462643383279;
+
+	// Bilinear lookup with clamp-to-edge and texel centres at (i + 0.5) / size, like GL_LINEAR:
+	template <typename Fetch>
+	float sampleBilinear(Fetch fetch, int width, int height, float u, float v)
+	{
+		float x = u * width - 0.5f;
+		float y = v * height - 0.5f;
+		int x0 = (int)floorf(x);
+		int y0 = (int)floorf(y);
+		float fx = x - x0;
+		float fy = y - y0;
+
+		auto texel = [&](int tx, int ty)
+		{
+			return fetch(glm::clamp(tx, 0, width - 1), glm::clamp(ty, 0, height - 1));
+		};
+		float bottom = texel(x0, y0) + (texel(x0 + 1, y0) - texel(x0, y0)) * fx;
+		float top = texel(x0, y0 + 1) + (texel(x0 + 1, y0 + 1) - texel(x0, y0 + 1)) * fx;
+		return bottom + (top - bottom) * fy;
+	}
+
+	// Distance from the light and cosine of the scattering angle (light's path vs the path on to the
+	// camera) at distance t along the ray:
+	void rayGeometry(double lightDist, double viewAngle, double t, double& dist, double& cosTheta)
+	{
+		double cosView = cos(viewAngle);
+		dist = sqrt(std::max(0.0, lightDist * lightDist - 2.0 * lightDist * t * cosView + t * t));
+		cosTheta = dist > 0.0 ? glm::clamp((lightDist * cosView - t) / dist, -1.0, 1.0) : 1.0;
+	}
+
+	double simpson(const ScatteringModel& model, double lightDist, double viewAngle, double a, double b, int intervals)
+	{
+		const double h = (b - a) / intervals;
+		double sum = model.inScattering(lightDist, viewAngle, a) + model.inScattering(lightDist, viewAngle, b);
+		for (int i = 1; i < intervals; ++i)
+			sum += model.inScattering(lightDist, viewAngle, a + i * h) * (i % 2 ? 4.0 : 2.0);
+		return sum * h / 3.0;
+	}
+
+	void getRayRange(float lightDist, float lightZFar, float& t0, float& tRange)
+	{
+		t0 = std::max(0.0f, lightDist - lightZFar);
+		tRange = lightDist + lightZFar - t0;
+	}
+}
+
+double ScatteringModel::inScattering(double lightDist, double viewAngle, double t) const
+{
+	double dist, cosTheta;
+	rayGeometry(lightDist, viewAngle, t, dist, cosTheta);
+
+	const double g = gParam;
+	double phase = 1.0 / (4.0 * PI) * ((1.0 - g * g) / pow(1.0 + g * g - 2.0 * g * cosTheta, 1.5));
+	return scattering * exp(-extinction * (dist + t)) * phase / (constant + linear * dist + quadratic * (dist * dist));
+}
+
+void ScatteringReference::bake(const ScatteringModel& model, float lightDist, float lightZFar, int width, int height, int samplesPerTexel,
+	std::vector<float>& table)
+{
+	float t0, tRange;
+	getRayRange(lightDist, lightZFar, t0, tRange);
+	const int intervals = std::max(2, samplesPerTexel + samplesPerTexel % 2);
+
+	table.resize((size_t)width * height);
+	m_pool.parallelFor(height, [&](int y)
+	{
+		const double viewAngle = (y + 0.5) / height * PI;
+		const double closest = lightDist * cos(viewAngle);
+
+		double sum = 0.0;
+		double tPrev = t0;
+		for (int x = 0; x < width; ++x)
+		{
+			const double t = t0 + (x + 0.5) / width * tRange;
+
+			// The integrand peaks where the ray passes the light, so keep that on an interval boundary:
+			if (closest > tPrev && closest < t)
+				sum += simpson(model, lightDist, viewAngle, tPrev, closest, intervals) + simpson(model, lightDist, viewAngle, closest, t, intervals);
+			else
+				sum += simpson(model, lightDist, viewAngle, tPrev, t, intervals);
+
+			table[(size_t)y * width + x] = (float)sum;
+			tPrev = t;
+		}
+	});
+}
+
+void ScatteringReference::evaluateHooblerLut(const std::vector<glm::vec4>& lut, int lutWidth, int lutHeight, const AxisWarp& distanceWarp, const AxisWarp& angleWarp,
+	int width, int height, std::vector<float>& table, int channel)
+{
+	auto fetch = [&](int x, int y)
+	{
+		const glm::vec4& s = lut[(size_t)y * lutWidth + x];
+		return s[channel] * s.a;
+	};
+
+	// Texel centres of the table are (t - t0) / tRange and viewAngle / pi, before warping. As in
+	// SampleHoobler(), LUT texel i holds the integral up to (i + 1) / lutWidth, so the lookup is moved back
+	// half a texel and ramps up from zero across the first:
+	table.resize((size_t)width * height);
+	m_pool.parallelFor(height, [&](int y)
+	{
+		const float v = angleWarp.encode((y + 0.5f) / height);
+		for (int x = 0; x < width; ++x)
+		{
+			const float u = distanceWarp.encode((x + 0.5f) / width);
+			const float ramp = std::min(u * lutWidth, 1.0f);
+			table[(size_t)y * width + x] = sampleBilinear(fetch, lutWidth, lutHeight, u - 0.5f / lutWidth, v) * ramp;
+		}
+	});
+}
+
+void ScatteringReference::evaluateKovalovsLut(const std::vector<float>& lut, int lutWidth, int lutHeight, const AxisWarp& distanceWarp, const AxisWarp& angleWarp,
+	float range, float lightDist, float lightZFar, int width, int height, int stepsPerTexel, std::vector<float>& table)
+{
+	float t0, tRange;
+	getRayRange(lightDist, lightZFar, t0, tRange);
+
+	auto fetch = [&](int x, int y)
+	{
+		return lut[(size_t)y * lutWidth + x];
+	};
+
+	table.resize((size_t)width * height);
+	m_pool.parallelFor(height, [&](int y)
+	{
+		const double viewAngle = (y + 0.5) / height * PI;
+
+		double sum = 0.0;
+		double tPrev = t0;
+		for (int x = 0; x < width; ++x)
+		{
+			const double t = t0 + (x + 0.5) / width * tRange;
+			const double step = (t - tPrev) / stepsPerTexel;
+			for (int i = 0; i < stepsPerTexel; ++i)
+			{
+				double dist, cosTheta;
+				rayGeometry(lightDist, viewAngle, tPrev + (i + 0.5) * step, dist, cosTheta);
+
+				// The LUT's centre is the light and +y the forward-scattering direction:
+				if (dist >= range)
+					continue;
+				float r = distanceWarp.encode((float)(dist / range));
+				float angle = angleWarp.encode((float)(acos(cosTheta) / PI)) * (float)PI;
+				float u = 0.5f + 0.5f * r * sinf(angle);
+				float v = 0.5f + 0.5f * r * cosf(angle);
+				sum += sampleBilinear(fetch, lutWidth, lutHeight, u, v) * step;
+			}
+
+			table[(size_t)y * width + x] = (float)sum;
+			tPrev = t;
+		}
+	});
+}
+
+void ScatteringReference::compare(const std::vector<float>& a, const std::vector<float>& b, float& rmse, float& maxError)
+{
+	double sumSqr = 0.0;
+	maxError = 0.0f;
+
+	const size_t count = std::min(a.size(), b.size());
+	for (size_t i = 0; i < count; ++i)
+	{
+		float diff = fabsf(a[i] - b[i]);
+		sumSqr += (double)diff * diff;
+		maxError = std::max(maxError, diff);
+	}
+	rmse = count > 0 ? (float)sqrt(sumSqr / count) : 0.0f;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "ThreadPool.h"
+#include "LutWarp.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// Single-light scattering model shared by the LUT shaders: Henyey-Greenstein phase times Phong
+// attenuation. The single-channel LUTs leave out extinction, and the spectral one (SpectralLut) applies it
+// per band.
+struct ScatteringModel
+{
+	float gParam	= 0.4f;
+	float constant	= 1.0f;
+	float linear{};
+	float quadratic{};
+
+	// A spectral band's scattering coefficient, which scales the in-scattering and extinguishes it along
+	// the light's path to the point and on to the camera. 1 and 0 match the single-channel LUTs:
+	double scattering = 1.0;
+	double extinction = 0.0;
+
+	// Integrand along a view ray from a camera 'lightDist' from the light, at 'viewAngle' radians from the
+	// camera-to-light direction, at distance 't' along the ray:
+	double inScattering(double lightDist, double viewAngle, double t) const;
+};
+
+// Brute-force ground truth for the scattering LUTs. Integrates the model along view rays with composite
+// Simpson's rule at high sample counts, split at the ray's closest approach to the light where the
+// integrand peaks, with the rows of the table spread over the thread pool. Also samples read-back LUTs
+// the way froxelInjectShader.comp does, so each method can be scored on the same grid.
+//
+// Tables use Hoobler's layout: x is the distance along the ray over [t0, t0 + tRange] and y the view
+// angle over [0, pi], with t0 = max(0, lightDist - lightZFar) and tRange = lightDist + lightZFar - t0.
+// Each entry is the in-scattering integrated from t0, evaluated at texel centres. The LUTs being scored
+// may warp their axes (AxisWarp), but the table doesn't.
+class ScatteringReference
+{
+public:
+	explicit ScatteringReference(ThreadPool& pool) : m_pool(pool) {};
+
+	// Ground truth, with 'samplesPerTexel' Simpson intervals between neighbouring texels:
+	void bake(const ScatteringModel& model, float lightDist, float lightZFar, int width, int height, int samplesPerTexel,
+		std::vector<float>& table);
+
+	// Hoobler's summed LUT (RGB scaled down by A) sampled like SampleHoobler(), from one of its channels:
+	void evaluateHooblerLut(const std::vector<glm::vec4>& lut, int lutWidth, int lutHeight, const AxisWarp& distanceWarp, const AxisWarp& angleWarp,
+		int width, int height, std::vector<float>& table, int channel = 0);
+
+	// Kovalovs' LUT, with 'range' mapped to its edge, integrated along each ray with 'stepsPerTexel'
+	// midpoint steps between neighbouring texels:
+	void evaluateKovalovsLut(const std::vector<float>& lut, int lutWidth, int lutHeight, const AxisWarp& distanceWarp, const AxisWarp& angleWarp,
+		float range, float lightDist, float lightZFar, int width, int height, int stepsPerTexel, std::vector<float>& table);
+
+	// RMSE and largest absolute difference of two tables of the same size:
+	static void compare(const std::vector<float>& a, const std::vector<float>& b, float& rmse, float& maxError);
+
+private:
+	ThreadPool& m_pool;
+};
@@ -0,0 +1,166 @@
+#include "SdfScene.h"
+#include <algorithm>
+
+namespace
+{
+	const char* TYPE_NAMES[] = { "sphere", "box", "torus", "plane", "capsule" };
+	const char* OP_NAMES[] = { "union", "subtract", "intersect" };
+
+	template <size_t N>
+	int findName(const char* (&names)[N], const std::string& name)
+	{
+		for (size_t i = 0; i < N; ++i)
+			if (name == names[i])
+				return (int)i;
+		return -1;
+	}
+}
+
+bool SdfScene::loadFromFile(const char* path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR::SCENE: Failed to open " << path << std::endl;
+		return false;
+	}
+
+	// Each line: type op blendK  position(3)  rotation(3)  scale  params(4). '#' starts a comment:
+	std::vector<Object> objects;
+	std::string line;
+	for (int lineNumber = 1; std::getline(file, line); ++lineNumber)
+	{
+		line = line.substr(0, line.find('#'));
+		std::istringstream stream(line);
+		std::string typeName, opName;
+		if (!(stream >> typeName))
+			continue;
+
+		Object object;
+		stream >> opName >> object.blendK
+			>> object.position.x >> object.position.y >> object.position.z
+			>> object.rotation.x >> object.rotation.y >> object.rotation.z
+			>> object.scale
+			>> object.params.x >> object.params.y >> object.params.z >> object.params.w;
+
+		int type = findName(TYPE_NAMES, typeName);
+		int op = findName(OP_NAMES, opName);
+		if (!stream || type < 0 || op < 0 || object.scale <= 0.0f)
+		{
+			std::cout << "ERROR::SCENE: Invalid primitive on line " << lineNumber << " of " << path << std::endl;
+			return false;
+		}
+		object.type = (Type)type;
+		object.op = (Op)op;
+		objects.push_back(object);
+	}
+
+	if ((int)objects.size() > MAX_PRIMITIVES)
+	{
+		std::cout << "ERROR::SCENE: " << path << " has " << objects.size() << " primitives, the limit is " << MAX_PRIMITIVES << std::endl;
+		return false;
+	}
+
+	m_objects = objects;
+	std::cout << "Loaded " << m_objects.size() << " primitives from " << path << std::endl;
+	return true;
+}
+
+void SdfScene::init()
+{
+	m_cullShader.loadShader("res/sdfTileCullShader.comp", getShaderDefines());
+
+	m_sceneBuffer = BufferHandle::create();
+	m_tileBuffer = BufferHandle::create();
+}
+
+void SdfScene::buildPrimitives()
+{
+	m_primitives.clear();
+	for (const Object& object : m_objects)
+		m_primitives.push_back(buildPrimitive(object));
+}
+
+void SdfScene::upload()
+{
+	buildPrimitives();
+
+	// Keep the buffer non-empty so it can always be bound:
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_sceneBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(m_primitives.size(), 1) * sizeof(SdfPrimitive), NULL, GL_STATIC_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_primitives.size() * sizeof(SdfPrimitive), m_primitives.data());
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	++m_version;
+}
+
+void SdfScene::cullTiles(const glm::vec3& cameraPos, int width, int height, bool enableCulling)
+{
+	const int tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	const int tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	// Each tile stores its count followed by room for every primitive:
+	const int tileStride = getPrimitiveCount() + 1;
+	const size_t tileBufferSize = (size_t)tilesX * tilesY * tileStride * sizeof(unsigned int);
+	if (tileBufferSize > m_tileBufferSize)
+	{
+		m_tileBufferSize = tileBufferSize;
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_tileBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_tileBufferSize, NULL, GL_DYNAMIC_COPY);
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	bind();
+	m_cullShader.use();
+	m_cullShader.setVec3("u_cameraPos", cameraPos);
+	m_cullShader.setVec2("u_frameSize", glm::vec2(width, height));
+	m_cullShader.setInt("u_primitiveCount", getPrimitiveCount());
+	m_cullShader.setBool("u_enableCulling", enableCulling);
+	glDispatchCompute(tilesX, tilesY, 1);
+
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void SdfScene::bind() const
+{
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, SCENE_BINDING, m_sceneBuffer);
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_BINDING, m_tileBuffer);
+}
+
+std::string SdfScene::getShaderDefines()
+{
+	return "#define MAX_PRIMITIVES " + std::to_string(MAX_PRIMITIVES) + "\n"
+		+ "#define TILE_SIZE " + std::to_string(TILE_SIZE) + "\n"
+		+ "#define SCENE_BINDING " + std::to_string(SCENE_BINDING) + "\n"
+		+ "#define TILE_BINDING " + std::to_string(TILE_BINDING) + "\n";
+}
+
+SdfPrimitive SdfScene::buildPrimitive(const Object& object)
+{
+	glm::mat4 localToWorld = glm::translate(glm::mat4(1.0f), object.position);
+	localToWorld = glm::rotate(localToWorld, glm::radians(object.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	localToWorld = glm::rotate(localToWorld, glm::radians(object.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	localToWorld = glm::rotate(localToWorld, glm::radians(object.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	localToWorld = glm::scale(localToWorld, glm::vec3(object.scale));
+
+	// Bounding radius in local space:
+	const glm::vec4& p = object.params;
+	float radius = -1.0f;
+	switch (object.type)
+	{
+		case Type::SPHERE:	radius = p.x; break;
+		case Type::BOX:		radius = glm::length(glm::vec3(p)); break;
+		case Type::TORUS:	radius = p.x + p.y; break;
+		case Type::PLANE:	radius = -1.0f; break;
+		case Type::CAPSULE:	radius = p.x + p.y; break;
+	}
+
+	SdfPrimitive primitive;
+	primitive.worldToLocal = glm::inverse(localToWorld);
+	primitive.params = object.params;
+	primitive.bounds = glm::vec4(object.position, radius < 0.0f ? -1.0f : radius * object.scale);
+	primitive.type = (int)object.type;
+	primitive.op = (int)object.op;
+	primitive.blendK = object.blendK;
+	primitive.scale = object.scale;
+	return primitive;
+}
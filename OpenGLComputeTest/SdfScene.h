@@ -0,0 +1,97 @@
+#pragma once
+#include "Shader.h"
+#include <vector>
+
+// Mirrors the std430 Primitive struct shared by raymarchComputeShader.comp and sdfTileCullShader.comp.
+// Every primitive is centred on its local origin, so the world-space bounding sphere is centred on its
+// position:
+struct SdfPrimitive
+{
+	glm::mat4 worldToLocal;	// Inverse of translation * rotation * uniform scale.
+	glm::vec4 params;		// Type-specific, see SdfScene::Type.
+	glm::vec4 bounds;		// World-space bounding sphere, w < 0 if unbounded.
+	int type;
+	int op;
+	float blendK;			// Smooth blend size, 0 = hard.
+	float scale;			// Local distances are multiplied by this to get world distances.
+};
+
+// A list of SDF primitives folded together in order, each combined with everything before it by its
+// blend op. Scenes are loaded from a text file (one primitive per line, see res/defaultScene.sdf) and
+// uploaded to an SSBO. A culling pass then builds a compact, ordered list of the primitives that can
+// affect each 16x16 tile of the raymarched image, so primary rays only evaluate what is near their tile.
+class SdfScene
+{
+public:
+	enum class Type {
+		SPHERE,		// x = radius.
+		BOX,		// xyz = half extents.
+		TORUS,		// x = major radius, y = minor radius, in the local xz plane.
+		PLANE,		// Local y = 0, facing +y. Unbounded.
+		CAPSULE		// x = half height along local y, y = radius.
+	};
+
+	enum class Op {
+		UNION,
+		SUBTRACT,
+		INTERSECT	// Not local, so never culled.
+	};
+
+	// Editable description of a primitive, converted to an SdfPrimitive on upload:
+	struct Object
+	{
+		Type type = Type::SPHERE;
+		Op op = Op::UNION;
+		float blendK{};
+		glm::vec3 position{};
+		glm::vec3 rotation{};	// Euler angles in degrees, applied in x, y, z order.
+		float scale = 1.0f;
+		glm::vec4 params{};
+	};
+
+	static const int MAX_PRIMITIVES = 256;
+	static const int TILE_SIZE = 16;
+	static const int SCENE_BINDING = 3;
+	static const int TILE_BINDING = 4;
+
+	SdfScene() {};
+
+	// Replaces the object list. Doesn't touch GL, so it can be used without a context. Returns false and
+	// leaves the scene unchanged if the file can't be read or has an invalid line:
+	bool loadFromFile(const char* path);
+
+	void init();
+
+	// Rebuild the primitive list from the objects. upload() also does this:
+	void buildPrimitives();
+
+	// Rebuild the primitive list and upload it:
+	void upload();
+
+	// Build the per-tile primitive lists for a width x height image seen from 'cameraPos'. With culling
+	// disabled every tile lists every primitive:
+	void cullTiles(const glm::vec3& cameraPos, int width, int height, bool enableCulling = true);
+
+	// Bind the primitive and tile buffers for the raymarcher:
+	void bind() const;
+
+	std::vector<Object>& getObjects()						{ return m_objects; }
+	const std::vector<SdfPrimitive>& getPrimitives() const	{ return m_primitives; }
+	int getPrimitiveCount() const							{ return (int)m_primitives.size(); }
+	int getVersion() const									{ return m_version; }	// Bumped by upload().
+
+	// #defines for shaders that read the scene:
+	static std::string getShaderDefines();
+
+	static SdfPrimitive buildPrimitive(const Object& object);
+
+private:
+	Shader m_cullShader;
+	std::vector<Object> m_objects;
+	std::vector<SdfPrimitive> m_primitives;
+
+	BufferHandle m_sceneBuffer;
+	BufferHandle m_tileBuffer;
+	size_t m_tileBufferSize{};
+	int m_version{};
+};
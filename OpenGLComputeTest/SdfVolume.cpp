@@ -0,0 +1,94 @@
+#include "SdfVolume.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+void SdfVolume::init()
+{
+	m_bakeShader.loadShader("res/raymarchComputeShader.comp", SdfScene::getShaderDefines() + "#define BAKE_SDF\n");
+}
+
+void SdfVolume::bake(const SdfScene& scene, int resolution, float band, bool cullSlabs)
+{
+	// Bounds of everything that ends, plus the band so surfaces near the edges are still inside it:
+	glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+	m_blendSlack = 0.0f;
+	for (const SdfPrimitive& prim : scene.getPrimitives())
+	{
+		if (prim.op == (int)SdfScene::Op::UNION)
+			m_blendSlack += prim.blendK * 0.25f;
+		if (prim.bounds.w < 0.0f)
+			continue;
+		boundsMin = glm::min(boundsMin, glm::vec3(prim.bounds) - prim.bounds.w);
+		boundsMax = glm::max(boundsMax, glm::vec3(prim.bounds) + prim.bounds.w);
+	}
+	m_sceneVersion = scene.getVersion();
+
+	// Nothing bounded to bake:
+	if (boundsMin.x > boundsMax.x)
+	{
+		m_texture.reset();
+		return;
+	}
+
+	// Cubic voxels, with the two axes covered by a group's slab rounded up to whole groups:
+	glm::vec3 extent = boundsMax - boundsMin;
+	m_voxelSize = std::max(extent.x, std::max(extent.y, extent.z)) / resolution;
+
+	// The band has to be wide enough for a clamped lookup, less its error, to clear the refine distance
+	// comfortably, or the march would never step by the volume alone:
+	m_band = std::max(band, m_voxelSize * sqrtf(3.0f) * 4.0f);
+	boundsMin -= m_band;
+	boundsMax += m_band;
+	extent = boundsMax - boundsMin;
+
+	const int groupSize = SdfScene::TILE_SIZE;
+	glm::ivec3 size = glm::ivec3(glm::ceil(extent / m_voxelSize));
+	size.x = (size.x + groupSize - 1) / groupSize * groupSize;
+	size.y = (size.y + groupSize - 1) / groupSize * groupSize;
+	m_boundsMin = boundsMin;
+	m_boundsMax = boundsMin + glm::vec3(size) * m_voxelSize;
+
+	// Storage is immutable, so a new size needs a new texture:
+	if (size != m_size || !m_texture)
+	{
+		m_texture = TextureHandle::create();
+		GLState::bindTexture(GL_TEXTURE_3D, m_texture);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexStorage3D(GL_TEXTURE_3D, 1, GL_R16F, size.x, size.y, size.z);
+		GLState::bindTexture(GL_TEXTURE_3D, 0);
+		m_size = size;
+	}
+
+	scene.bind();
+	m_bakeShader.use();
+	m_bakeShader.setInt("u_primitiveCount", scene.getPrimitiveCount());
+	m_bakeShader.setVec3("u_sdfBoundsMin", m_boundsMin);
+	m_bakeShader.setVec3("u_sdfBoundsMax", m_boundsMax);
+	m_bakeShader.setFloat("u_sdfBand", m_band);
+	m_bakeShader.setBool("u_sdfCullSlabs", cullSlabs);
+
+	GLState::bindImageTexture(2, m_texture, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R16F);
+	glDispatchCompute(size.x / groupSize, size.y / groupSize, size.z);
+
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void SdfVolume::setUniforms(const Shader& shader, int unit) const
+{
+	const float voxelDiagonal = m_voxelSize * sqrtf(3.0f);
+
+	GLState::activeTexture(GL_TEXTURE0 + unit);
+	GLState::bindTexture(GL_TEXTURE_3D, m_texture);
+	shader.setInt("u_sdfVolume", unit);
+	shader.setVec3("u_sdfBoundsMin", m_boundsMin);
+	shader.setVec3("u_sdfBoundsMax", m_boundsMax);
+	shader.setFloat("u_sdfBand", m_band);
+	shader.setFloat("u_sdfVoxelDiagonal", voxelDiagonal);
+	shader.setFloat("u_sdfRefineDistance", voxelDiagonal * 0.5f);
+	shader.setFloat("u_sdfBlendSlack", m_blendSlack);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "GLHandle.h"
+#include "SdfScene.h"
+
+// SDF scene baked into a 3D R16F texture covering the bounds of its bounded primitives, with cubic
+// voxels and distances clamped to a narrow band around the surfaces. The raymarcher steps through it with
+// trilinear lookups and only evaluates the analytic scene close to a surface. It has to be rebaked
+// whenever the scene changes; `--benchmark` times the bake and the march against the analytic scene.
+class SdfVolume
+{
+public:
+	SdfVolume() {};
+
+	void init();
+
+	// 'resolution' is the voxel count along the longest side, 'band' the largest stored distance (raised
+	// to four voxel diagonals if smaller). 'cullSlabs' off evaluates every primitive at every voxel, for
+	// comparison:
+	void bake(const SdfScene& scene, int resolution, float band, bool cullSlabs = true);
+
+	// Bind the texture to 'unit' and set the u_sdf* uniforms of raymarchComputeShader.comp:
+	void setUniforms(const Shader& shader, int unit) const;
+
+	bool isBaked() const				{ return m_texture != 0; }
+	unsigned int getTexture() const		{ return m_texture; }
+	glm::ivec3 getSize() const			{ return m_size; }
+	float getVoxelSize() const			{ return m_voxelSize; }
+	int getBakedSceneVersion() const	{ return m_sceneVersion; }
+
+private:
+	Shader m_bakeShader;
+	TextureHandle m_texture;
+
+	glm::ivec3 m_size{};
+	glm::vec3 m_boundsMin{}, m_boundsMax{};
+	float m_voxelSize{};
+	float m_band{};
+	float m_blendSlack{};
+	int m_sceneVersion = -1;
+};
@@ -5,6 +5,11 @@ Shader::Shader(const char* computePath)
 	loadShader(computePath);
 }
 
+Shader::Shader(const char* computePath, const std::string& defines)
+{
+	loadShader(computePath, defines);
+}
+
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
 {
 	loadShader(vertexPath, fragmentPath);
@@ -17,16 +22,21 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geo
 
 void Shader::use() const
 {
-	glUseProgram(m_ID);
+	m_ID.bind();
 }
 
 void Shader::loadShader(const char* computePath)
 {
-	unsigned int c = setupStage(computePath, GL_COMPUTE_SHADER);
+	loadShader(computePath, "");
+}
+
+void Shader::loadShader(const char* computePath, const std::string& defines)
+{
+	unsigned int c = setupStage(computePath, GL_COMPUTE_SHADER, defines);
 	int success;
 	char infoLog[512];
 
-	m_ID = glCreateProgram();
+	m_ID = ProgramHandle::create();
 	glAttachShader(m_ID, c);
 	glLinkProgram(m_ID);
 
@@ -51,7 +61,7 @@ void Shader::loadShader(const char* vertexPath, const char* fragmentPath)
 	char infoLog[512];
 
 	// Create shader program:
-	m_ID = glCreateProgram();
+	m_ID = ProgramHandle::create();
 	glAttachShader(m_ID, v);
 	glAttachShader(m_ID, f);
 	glLinkProgram(m_ID);
@@ -81,7 +91,7 @@ void Shader::loadShader(const char* vertexPath, const char* fragmentPath, const
 	char infoLog[512];
 
 	// Create shader program:
-	m_ID = glCreateProgram();
+	m_ID = ProgramHandle::create();
 	glAttachShader(m_ID, v);
 	glAttachShader(m_ID, f);
 	glAttachShader(m_ID, g);
@@ -128,6 +138,11 @@ void Shader::setVec2(const std::string& name, float x, float y) const
 	glUniform2f(glGetUniformLocation(m_ID, name.c_str()), x, y);
 }
 
+void Shader::setIVec2(const std::string& name, glm::ivec2 val) const
+{
+	glUniform2i(glGetUniformLocation(m_ID, name.c_str()), val.x, val.y);
+}
+
 void Shader::setVec3(const std::string& name, glm::vec3 val) const
 {
 	glUniform3f(glGetUniformLocation(m_ID, name.c_str()), val.x, val.y, val.z);
@@ -153,7 +168,7 @@ void Shader::setMat4(const std::string& name, glm::mat4 val) const
 	glUniformMatrix4fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(val));
 }
 
-unsigned int Shader::setupStage(const char* path, unsigned int type)
+std::string Shader::readSource(const std::string& path, int depth)
 {
 	// Containers for shader code and file streams:
 	std::string code;
@@ -179,6 +194,48 @@ unsigned int Shader::setupStage(const char* path, unsigned int type)
 	{
 		std::cout << "SHADER FILE NOT SUCCESSFULLY READ\n(" << path << ")\n\n";
 	}
+
+	// Splice in '#include "file"' lines, relative to this file, so shaders can share GLSL:
+	const size_t slash = path.find_last_of("/\\");
+	const std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+	size_t lineStart = 0;
+	while ((lineStart = code.find("#include", lineStart)) != std::string::npos)
+	{
+		// Only directives at the start of a line:
+		if (lineStart > 0 && code[lineStart - 1] != '\n')
+		{
+			lineStart += 1;
+			continue;
+		}
+
+		size_t lineEnd = code.find('\n', lineStart);
+		size_t open = code.find('"', lineStart);
+		size_t close = open == std::string::npos ? open : code.find('"', open + 1);
+		if (close == std::string::npos || close > lineEnd || depth >= MAX_INCLUDE_DEPTH)
+		{
+			std::cout << "SHADER INCLUDE NOT RESOLVED\n(" << path << ")\n\n";
+			break;
+		}
+
+		std::string included = readSource(directory + code.substr(open + 1, close - open - 1), depth + 1);
+		code.replace(lineStart, (lineEnd == std::string::npos ? code.size() : lineEnd) - lineStart, included);
+		lineStart += included.size();
+	}
+	return code;
+}
+
+unsigned int Shader::setupStage(const char* path, unsigned int type, const std::string& defines)
+{
+	std::string code = readSource(path, 0);
+
+	// Insert any variant defines straight after the #version directive:
+	if (!defines.empty())
+	{
+		size_t versionEnd = code.find('\n', code.find("#version"));
+		if (versionEnd != std::string::npos)
+			code.insert(versionEnd + 1, defines);
+	}
 	const char* shaderCode = code.c_str();
 
 	unsigned int shaderHandle;
@@ -3,6 +3,7 @@
 #define SHADER_H
 
 #include <glad4.3/glad4.3.h>
+#include "GLHandle.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -15,15 +16,17 @@
 class Shader
 {
 public:
-	unsigned int m_ID{};	// Program ID
+	ProgramHandle m_ID;	// Program ID
 
 	Shader() {};
 	Shader(const char* computePath);
+	Shader(const char* computePath, const std::string& defines);
 	Shader(const char* vertexPath, const char* fragmentPath);
 	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath);
 	
 	void use() const;
 	void loadShader(const char* computePath);
+	void loadShader(const char* computePath, const std::string& defines);
 	void loadShader(const char* vertexPath, const char* fragmentPath);
 	void loadShader(const char* vertexPath, const char* fragmentPath, const char* geometryPath);
 
@@ -32,6 +35,7 @@ public:
 	void setFloat(const std::string& name, float val) const;
 	void setVec2(const std::string& name, glm::vec2 val) const;
 	void setVec2(const std::string& name, float x, float y) const;
+	void setIVec2(const std::string& name, glm::ivec2 val) const;
 	void setVec3(const std::string& name, glm::vec3 val) const;
 	void setVec3(const std::string& name, float x, float y, float z) const;
 	void setVec4(const std::string& name, glm::vec4 val) const;
@@ -39,7 +43,12 @@ public:
 	void setMat4(const std::string& name, glm::mat4 val) const;
 
 private:
-	unsigned int setupStage(const char* path, unsigned int type);
+	static const int MAX_INCLUDE_DEPTH = 8;
+
+	// The file's code with its includes resolved:
+	static std::string readSource(const std::string& path, int depth);
+
+	unsigned int setupStage(const char* path, unsigned int type, const std::string& defines = "");
 };
 
 #endif // !SHDAER_H
\ No newline at end of file
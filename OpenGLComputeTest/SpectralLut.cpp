@@ -0,0 +1,87 @@
+#include "SpectralLut.h"
+#include <algorithm>
+
+void SpectralLut::init()
+{
+	const std::string defines = "#define SPECTRAL\n#define MAX_SPECTRAL_BANDS " + std::to_string(MAX_BANDS) + "\n";
+	m_accumShader.loadShader("res/hooblerAccumLUTShader.comp", defines);
+	m_sumShader.loadShader("res/hooblerSumLUTShader.comp", defines);
+
+	m_segmentTex = TextureHandle::create();
+	m_summedTex = TextureHandle::create();
+
+	for (GLuint tex : { m_segmentTex.get(), m_summedTex.get() })
+	{
+		GLState::bindTexture(GL_TEXTURE_2D_ARRAY, tex);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	}
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void SpectralLut::allocate(glm::ivec2 size, int layers)
+{
+	m_allocatedSize = size;
+	m_layers = layers;
+	for (GLuint tex : { m_segmentTex.get(), m_summedTex.get() })
+	{
+		GLState::bindTexture(GL_TEXTURE_2D_ARRAY, tex);
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA32F, size.x, size.y, layers, 0, GL_RGBA, GL_FLOAT, NULL);
+	}
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void SpectralLut::bake(const Params& params, glm::ivec2 size)
+{
+	m_bandCount = std::min((int)params.coefficients.size(), MAX_BANDS);
+	const int layers = std::max(1, (m_bandCount + BANDS_PER_LAYER - 1) / BANDS_PER_LAYER);
+	if (size.x > m_allocatedSize.x || size.y > m_allocatedSize.y || layers != m_layers)
+		allocate(glm::max(size, m_allocatedSize), layers);
+
+	m_accumShader.use();
+	m_accumShader.setFloat("u_gParam", params.gParam);
+	m_accumShader.setFloat("u_vecLength", params.vecLength);
+	m_accumShader.setFloat("u_lightZFar", params.lightZFar);
+	m_accumShader.setFloat("u_constant", params.constant);
+	m_accumShader.setFloat("u_linear", params.linear);
+	m_accumShader.setFloat("u_quadratic", params.quadratic);
+	m_accumShader.setFloat("u_lutScale", params.lutScale);
+	m_accumShader.setIVec2("u_lutSize", size);
+	params.distanceWarp.setUniforms(m_accumShader, "u_distance");
+	params.angleWarp.setUniforms(m_accumShader, "u_angle");
+	m_accumShader.setInt("u_bandCount", m_bandCount);
+	for (int i = 0; i < m_bandCount; ++i)
+		m_accumShader.setFloat("u_bandCoefficients[" + std::to_string(i) + "]", params.coefficients[i]);
+
+	GLState::bindImageTexture(4, m_segmentTex, 0, GL_TRUE, 0, GL_READ_WRITE, GL_RGBA32F);
+	GLState::bindImageTexture(5, m_summedTex, 0, GL_TRUE, 0, GL_READ_WRITE, GL_RGBA32F);
+	glDispatchCompute(size.x / 32, size.y / 8, layers);
+
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+	// Each group sums whole rows of one layer:
+	m_sumShader.use();
+	m_sumShader.setIVec2("u_lutSize", size);
+	glDispatchCompute(1, size.y / 4, layers);
+}
+
+void SpectralLut::readLayer(int layer, std::vector<glm::vec4>& texels) const
+{
+	std::vector<glm::vec4> all((size_t)m_allocatedSize.x * m_allocatedSize.y * m_layers);
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_summedTex);
+	glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_FLOAT, all.data());
+	GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	const size_t layerSize = (size_t)m_allocatedSize.x * m_allocatedSize.y;
+	texels.assign(all.begin() + layer * layerSize, all.begin() + (layer + 1) * layerSize);
+}
+
+float SpectralLut::getBandWavelength(int band, int bandCount, float first, float last)
+{
+	if (bandCount < 2)
+		return first;
+	return first + (last - first) * band / (bandCount - 1);
+}
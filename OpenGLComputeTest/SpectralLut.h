@@ -0,0 +1,58 @@
+#pragma once
+#include "Shader.h"
+#include "LutWarp.h"
+#include <vector>
+
+// Hoobler's LUT baked for several wavelength bands at once. Each band's scattering coefficient scales the
+// in-scattering and extinguishes it along the light's path to the point and on to the camera, where the
+// single-channel bake leaves extinction out. Bands are packed three to a texel's RGB (A keeps the LUT's
+// encoding scale) with one array layer per three, and the SPECTRAL variants of Hoobler's bake shaders
+// fill every layer from the same two dispatches, so full colour costs one pass rather than one per channel.
+class SpectralLut
+{
+public:
+	static const int MAX_BANDS = 12;
+	static const int BANDS_PER_LAYER = 3;
+
+	struct Params
+	{
+		std::vector<float> coefficients;	// Scattering coefficient per band, up to MAX_BANDS.
+		float vecLength{};
+		float lightZFar = 50.0f;
+		float gParam{};
+		float constant = 1.0f, linear{}, quadratic{};
+		float lutScale = 1.0f;				// Encoding scale, as u_lutScale.
+		AxisWarp distanceWarp, angleWarp;
+	};
+
+	SpectralLut() {};
+
+	void init();
+
+	// Bake the width x height region at the origin of every layer, growing the arrays to fit:
+	void bake(const Params& params, glm::ivec2 size);
+
+	// Read one layer of the summed LUT back, at its allocated size:
+	void readLayer(int layer, std::vector<glm::vec4>& texels) const;
+
+	// Summed LUT, as hooblerSummedLutTex with each layer holding three bands:
+	unsigned int getSummedTexture() const	{ return m_summedTex; }
+	int getBandCount() const				{ return m_bandCount; }
+	int getLayerCount() const				{ return m_layers; }
+	glm::ivec2 getAllocatedSize() const		{ return m_allocatedSize; }
+
+	// Wavelength of each band, spread evenly from 'first' to 'last' nm:
+	static float getBandWavelength(int band, int bandCount, float first, float last);
+
+private:
+	void allocate(glm::ivec2 size, int layers);
+
+	Shader m_accumShader;
+	Shader m_sumShader;
+
+	TextureHandle m_segmentTex;	// Each row segment's running sum, as hooblerAccumLutTex.
+	TextureHandle m_summedTex;
+	glm::ivec2 m_allocatedSize{};
+	int m_layers{};
+	int m_bandCount{};
+};
@@ -0,0 +1,241 @@
+#include "TextureLoader.h"
+#include "GLDsa.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	// Float to half without branches, so the conversion loops vectorise. Clamps to the largest half (NaN
+	// included), flushes anything below the smallest normal half to zero and rounds half up:
+	inline uint16_t toHalf(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		const uint32_t sign = (bits >> 16) & 0x8000u;
+		const uint32_t magnitude = std::min(bits & 0x7fffffffu, 0x477fe000u);
+		const uint32_t half = (magnitude - 0x38000000u + 0x1000u) >> 13;	// Exponent rebiased from 127 to 15.
+		return (uint16_t)(sign | (magnitude < 0x38800000u ? 0u : half));
+	}
+
+	// Expand 'Channels' interleaved channels to RGBA (grey to RGB, missing alpha to 'opaque'), flipping the
+	// rows so the bottom one comes first as GL expects. With the channel count fixed the inner loop is
+	// straight-line and vectorises:
+	template <int Channels, typename In, typename Out, typename Convert>
+	void convertToRgba(const In* src, Out* dst, int width, int height, In opaque, Convert convert)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			const In* srcRow = src + (size_t)(height - 1 - y) * width * Channels;
+			Out* dstRow = dst + (size_t)y * width * 4;
+			for (int x = 0; x < width; ++x)
+			{
+				const In* in = srcRow + x * Channels;
+				Out* out = dstRow + x * 4;
+				out[0] = convert(in[0]);
+				out[1] = convert(in[Channels >= 3 ? 1 : 0]);
+				out[2] = convert(in[Channels >= 3 ? 2 : 0]);
+				out[3] = convert(Channels == 2 || Channels == 4 ? in[Channels - 1] : opaque);
+			}
+		}
+	}
+
+	template <typename In, typename Out, typename Convert>
+	bool convertToRgba(int channels, const In* src, Out* dst, int width, int height, In opaque, Convert convert)
+	{
+		switch (channels)
+		{
+			case 1:	convertToRgba<1>(src, dst, width, height, opaque, convert); return true;
+			case 2:	convertToRgba<2>(src, dst, width, height, opaque, convert); return true;
+			case 3:	convertToRgba<3>(src, dst, width, height, opaque, convert); return true;
+			case 4:	convertToRgba<4>(src, dst, width, height, opaque, convert); return true;
+			default: return false;
+		}
+	}
+
+	int getBytesPerPixel(bool hdr)
+	{
+		return hdr ? 4 * sizeof(uint16_t) : 4;
+	}
+}
+
+void TextureLoader::init(GLsizeiptr stagingSize)
+{
+	// Mapped once where DSA allows it, otherwise orphaned through buffer updates:
+	m_stagingSize = stagingSize;
+	const Buffer::Usage usage = GLDsa::isAvailable() ? Buffer::Usage::PERSISTENT : Buffer::Usage::STREAM;
+	for (StagingBuffer& staging : m_staging)
+		staging.buffer.allocate<unsigned char>(GL_PIXEL_UNPACK_BUFFER, (size_t)stagingSize, usage);
+}
+
+int TextureLoader::load(const std::string& path, bool mipmaps)
+{
+	std::shared_ptr<Load> load = std::make_shared<Load>();
+	load->path = path;
+	load->mipmaps = mipmaps;
+	m_loads.push_back(load);
+
+	m_pool.submit([load] { decode(*load); });
+	return (int)m_loads.size() - 1;
+}
+
+void TextureLoader::decode(Load& load)
+{
+	int width, height, channels;
+	bool converted = false;
+	load.hdr = stbi_is_hdr(load.path.c_str()) != 0;
+	if (load.hdr)
+	{
+		float* data = stbi_loadf(load.path.c_str(), &width, &height, &channels, 0);
+		if (data)
+		{
+			load.pixels.resize((size_t)width * height * getBytesPerPixel(true));
+			converted = convertToRgba(channels, data, (uint16_t*)load.pixels.data(), width, height, 1.0f, toHalf);
+			stbi_image_free(data);
+		}
+	}
+	else
+	{
+		stbi_uc* data = stbi_load(load.path.c_str(), &width, &height, &channels, 0);
+		if (data)
+		{
+			load.pixels.resize((size_t)width * height * getBytesPerPixel(false));
+			converted = convertToRgba(channels, data, load.pixels.data(), width, height, (stbi_uc)255, [](stbi_uc c) { return c; });
+			stbi_image_free(data);
+		}
+	}
+
+	if (!converted)
+	{
+		load.error = stbi_failure_reason() ? stbi_failure_reason() : "unsupported channel count";
+		load.pixels = std::vector<unsigned char>();
+		load.state.store(State::FAILED, std::memory_order_release);
+		return;
+	}
+
+	load.width = width;
+	load.height = height;
+	load.state.store(State::UPLOADING, std::memory_order_release);
+}
+
+void TextureLoader::update()
+{
+	m_bytesUploaded = 0;
+
+	for (const std::shared_ptr<Load>& loadPtr : m_loads)
+	{
+		Load& load = *loadPtr;
+		const State state = load.state.load(std::memory_order_acquire);
+		if (state == State::FAILED && !load.reported)
+		{
+			std::cout << "ERROR::TEXTURE_LOADER: Failed to load " << load.path << ": " << load.error << std::endl;
+			load.reported = true;
+		}
+		if (state != State::UPLOADING)
+			continue;
+
+		// A band of at least one row has to fit in a staging buffer:
+		if ((GLsizeiptr)load.width * getBytesPerPixel(load.hdr) > m_stagingSize)
+		{
+			load.error = "rows are wider than the staging buffers";
+			load.pixels = std::vector<unsigned char>();
+			load.state = State::FAILED;
+			continue;
+		}
+
+		StagingBuffer* staging = nullptr;
+		while (load.rowsUploaded < load.height && (staging = acquireStagingBuffer()))
+			uploadRows(load, *staging);
+		if (load.rowsUploaded < load.height)
+			break;
+
+		if (load.mipmaps)
+		{
+			load.texture.bind(GL_TEXTURE_2D);
+			glGenerateMipmap(GL_TEXTURE_2D);
+		}
+		load.pixels = std::vector<unsigned char>();
+		load.state = State::READY;
+	}
+
+	// Left bound, it would turn every other glTex*Image() pointer into a buffer offset:
+	GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+TextureLoader::StagingBuffer* TextureLoader::acquireStagingBuffer()
+{
+	StagingBuffer& staging = m_staging[m_nextStaging];
+	if (staging.fence)
+	{
+		const GLenum status = glClientWaitSync(staging.fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			return nullptr;
+		staging.fence.reset();
+	}
+
+	m_nextStaging = (m_nextStaging + 1) % STAGING_BUFFER_COUNT;
+	return &staging;
+}
+
+void TextureLoader::uploadRows(Load& load, StagingBuffer& staging)
+{
+	if (!load.texture)
+	{
+		const int levels = load.mipmaps ? 1 + (int)std::log2((float)std::max(load.width, load.height)) : 1;
+		load.texture = GLDsa::createTexture2D(load.hdr ? GL_RGBA16F : GL_RGBA8, load.width, load.height, levels,
+			load.mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR, GL_LINEAR);
+	}
+
+	const GLsizeiptr rowBytes = (GLsizeiptr)load.width * getBytesPerPixel(load.hdr);
+	const int rows = std::min(load.height - load.rowsUploaded, (int)(m_stagingSize / rowBytes));
+	staging.buffer.update(0, rows * rowBytes, load.pixels.data() + load.rowsUploaded * rowBytes);
+
+	staging.buffer.bind();
+	load.texture.bind(GL_TEXTURE_2D);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, load.rowsUploaded, load.width, rows, GL_RGBA, load.hdr ? GL_HALF_FLOAT : GL_UNSIGNED_BYTE, (void*)0);
+	staging.fence.reset(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	load.rowsUploaded += rows;
+	m_bytesUploaded += rows * rowBytes;
+}
+
+float TextureLoader::getProgress(int index) const
+{
+	const Load& load = *m_loads[index];
+	const State state = load.state.load(std::memory_order_acquire);
+	if (state == State::READY)
+		return 1.0f;
+	if (state != State::UPLOADING || load.height == 0)
+		return 0.0f;
+	return (float)load.rowsUploaded / (float)load.height;
+}
+
+int TextureLoader::getWidth(int index) const
+{
+	const Load& load = *m_loads[index];
+	return load.state.load(std::memory_order_acquire) == State::DECODING ? 0 : load.width;
+}
+
+int TextureLoader::getHeight(int index) const
+{
+	const Load& load = *m_loads[index];
+	return load.state.load(std::memory_order_acquire) == State::DECODING ? 0 : load.height;
+}
+
+GLuint TextureLoader::getTexture(int index) const
+{
+	const Load& load = *m_loads[index];
+	return load.state == State::READY ? load.texture.get() : 0;
+}
+
+int TextureLoader::getPendingCount() const
+{
+	int pending = 0;
+	for (const std::shared_ptr<Load>& load : m_loads)
+		if (load->state == State::DECODING || load->state == State::UPLOADING)
+			++pending;
+	return pending;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "ThreadPool.h"
+#include "Buffer.h"
+#include <atomic>
+#include <string>
+
+// Loads image files into 2D textures without stalling the frame loop. Files are decoded by stb_image on
+// a thread pool and converted there to RGBA8 (LDR) or RGBA16F (HDR), bottom row first. Once a frame,
+// update() streams whatever has been decoded to the GPU in bands of rows through a small ring of pixel
+// unpack buffers, each fenced after its glTexSubImage2D(). A buffer the GPU hasn't finished copying from
+// ends that frame's uploads rather than being waited on, so nothing on the render thread ever blocks on
+// the workers or the GPU.
+// Give the loader a pool of its own: ThreadPool::wait(), and so parallelFor(), waits for every task on
+// the pool, decodes included.
+class TextureLoader
+{
+public:
+	enum class State
+	{
+		DECODING,	// Queued or being decoded on the pool.
+		UPLOADING,	// Decoded, waiting for or part way through its uploads.
+		READY,
+		FAILED
+	};
+
+	static const int STAGING_BUFFER_COUNT = 3;
+	static const GLsizeiptr DEFAULT_STAGING_SIZE = 4 * 1024 * 1024;
+
+	explicit TextureLoader(ThreadPool& pool) : m_pool(pool) {};
+
+	// 'stagingSize' bytes per pixel unpack buffer, which bounds the upload per buffer each frame:
+	void init(GLsizeiptr stagingSize = DEFAULT_STAGING_SIZE);
+
+	// Queue a file for decoding. Returns the index the getters take:
+	int load(const std::string& path, bool mipmaps = true);
+
+	// On the render thread, once a frame:
+	void update();
+
+	int getCount() const							{ return (int)m_loads.size(); }
+	const std::string& getPath(int index) const		{ return m_loads[index]->path; }
+	State getState(int index) const					{ return m_loads[index]->state; }
+	float getProgress(int index) const;				// Fraction of the rows uploaded.
+	int getWidth(int index) const;					// 0 while decoding.
+	int getHeight(int index) const;
+	GLuint getTexture(int index) const;				// 0 until READY.
+
+	// Loads not yet READY or FAILED, and the bytes the last update() uploaded:
+	int getPendingCount() const;
+	GLsizeiptr getBytesUploaded() const				{ return m_bytesUploaded; }
+
+private:
+	struct Load
+	{
+		std::string path;
+		bool mipmaps{};
+		std::atomic<State> state{ State::DECODING };
+
+		// Written by the decoding worker before it moves the state on:
+		std::vector<unsigned char> pixels;
+		int width{}, height{};
+		bool hdr{};
+		std::string error;
+
+		// Render thread only:
+		TextureHandle texture;
+		int rowsUploaded{};
+		bool reported{};
+	};
+
+	struct StagingBuffer
+	{
+		Buffer buffer;
+		SyncHandle fence;	// Issued after the last copy out of the buffer.
+	};
+
+	static void decode(Load& load);
+
+	// Next staging buffer of the ring, or null if the GPU may still be copying from it:
+	StagingBuffer* acquireStagingBuffer();
+	void uploadRows(Load& load, StagingBuffer& staging);
+
+	ThreadPool& m_pool;
+	std::vector<std::shared_ptr<Load>> m_loads;		// Shared with the decode tasks, which may outlive the loader.
+
+	StagingBuffer m_staging[STAGING_BUFFER_COUNT];
+	GLsizeiptr m_stagingSize{};
+	int m_nextStaging{};
+	GLsizeiptr m_bytesUploaded{};
+};
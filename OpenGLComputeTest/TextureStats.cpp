@@ -0,0 +1,104 @@
+#include "TextureStats.h"
+#include <cstring>
+
+void TextureStats::init()
+{
+	m_reduceShader.loadShader("res/textureStatsReduceShader.comp");
+	m_histogramShader.loadShader("res/textureStatsHistogramShader.comp");
+
+	// Group counter must start at zero, after that the last group resets it:
+	Result zero{};
+	m_statsBuffer = BufferHandle::create();
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_statsBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Result), &zero, GL_DYNAMIC_COPY);
+
+	m_partialsBuffer = BufferHandle::create();
+	for (int i = 0; i < READBACK_COUNT; ++i)
+	{
+		m_readbackBuffers[i] = BufferHandle::create();
+		GLState::bindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffers[i]);
+		glBufferData(GL_COPY_WRITE_BUFFER, sizeof(Result), NULL, GL_STREAM_READ);
+	}
+	GLState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void TextureStats::compute(unsigned int texture, int width, int height, int channel)
+{
+	// Each group covers a 32x32 tile:
+	const int groupsX = (width + 31) / 32;
+	const int groupsY = (height + 31) / 32;
+
+	// Three vec4s per group:
+	if (groupsX * groupsY > m_partialsCapacity)
+	{
+		m_partialsCapacity = groupsX * groupsY;
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, m_partialsBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_partialsCapacity * 3 * sizeof(glm::vec4), NULL, GL_DYNAMIC_COPY);
+		GLState::bindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, texture);
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_partialsBuffer);
+	GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, STATS_BINDING, m_statsBuffer);
+
+	// Source may have just been written through an image:
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+	m_reduceShader.use();
+	m_reduceShader.setInt("u_source", 0);
+	m_reduceShader.setIVec2("u_size", glm::ivec2(width, height));
+	glDispatchCompute(groupsX, groupsY, 1);
+
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	m_histogramShader.use();
+	m_histogramShader.setInt("u_source", 0);
+	m_histogramShader.setInt("u_channel", channel);
+	m_histogramShader.setIVec2("u_size", glm::ivec2(width, height));
+	glDispatchCompute(groupsX, groupsY, 1);
+
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	// Queue a copy for the CPU, unless every readback buffer is still waiting to be collected:
+	if (m_fences[m_writeIndex])
+		return;
+
+	GLState::bindBuffer(GL_COPY_READ_BUFFER, m_statsBuffer);
+	GLState::bindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffers[m_writeIndex]);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(Result));
+	GLState::bindBuffer(GL_COPY_READ_BUFFER, 0);
+	GLState::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	m_fences[m_writeIndex].reset(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	m_writeIndex = (m_writeIndex + 1) % READBACK_COUNT;
+}
+
+bool TextureStats::poll(Result& result)
+{
+	bool found = false;
+
+	// Drain every completed copy so the newest one is returned:
+	while (m_fences[m_readIndex])
+	{
+		GLenum status = glClientWaitSync(m_fences[m_readIndex], 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			break;
+
+		m_fences[m_readIndex].reset();
+
+		GLState::bindBuffer(GL_COPY_READ_BUFFER, m_readbackBuffers[m_readIndex]);
+		void* data = glMapBufferRange(GL_COPY_READ_BUFFER, 0, sizeof(Result), GL_MAP_READ_BIT);
+		if (data)
+		{
+			memcpy(&result, data, sizeof(Result));
+			found = true;
+		}
+		glUnmapBuffer(GL_COPY_READ_BUFFER);
+		GLState::bindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		m_readIndex = (m_readIndex + 1) % READBACK_COUNT;
+	}
+	return found;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Shader.h"
+
+// GPU reduction giving the per-channel min, max and mean of a 2D float texture plus a histogram of one
+// channel, in two dispatches. Results stay in an SSBO (binding 2) for shaders that want them straight
+// away, and are copied into a ring of readback buffers so the CPU can pick them up a few frames later
+// without stalling.
+class TextureStats
+{
+public:
+	static const int HISTOGRAM_BINS = 256;
+	static const int STATS_BINDING = 2;
+
+	// Mirrors the std430 Stats block in textureStatsReduceShader.comp:
+	struct Result
+	{
+		glm::vec4 minVal;
+		glm::vec4 maxVal;
+		glm::vec4 mean;
+		unsigned int histogram[HISTOGRAM_BINS];
+		unsigned int groupsDone;
+	};
+
+	TextureStats() {};
+
+	void init();
+
+	// Reduce the width x height region at the origin of level 0 of 'texture' and histogram 'channel' (0-3)
+	// over the [min, max] range of that channel:
+	void compute(unsigned int texture, int width, int height, int channel = 0);
+
+	// Returns true and fills 'result' if a readback has completed since the last call. Never blocks:
+	bool poll(Result& result);
+
+	unsigned int getStatsBuffer() const { return m_statsBuffer; }
+
+private:
+	static const int READBACK_COUNT = 3;
+
+	Shader m_reduceShader;
+	Shader m_histogramShader;
+
+	BufferHandle m_partialsBuffer;
+	BufferHandle m_statsBuffer;
+	int m_partialsCapacity{};
+
+	// Ring of readback buffers guarded by fences. m_readIndex is the oldest copy still in flight:
+	BufferHandle m_readbackBuffers[READBACK_COUNT];
+	SyncHandle m_fences[READBACK_COUNT];
+	int m_writeIndex{};
+	int m_readIndex{};
+};
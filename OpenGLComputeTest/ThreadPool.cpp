@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+		threadCount = 1;
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+		m_workers.emplace_back(new Worker);
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+		m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		m_stop = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	// Spread new tasks round-robin, stealing evens out whatever imbalance is left:
+	unsigned int index = m_nextWorker++ % m_workers.size();
+	{
+		std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+		m_workers[index]->tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		++m_queuedTasks;
+		++m_pendingTasks;
+	}
+	m_wakeCondition.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(m_stateMutex);
+	m_doneCondition.wait(lock, [this] { return m_pendingTasks == 0; });
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& fn)
+{
+	for (int i = 0; i < count; ++i)
+		submit([&fn, i] { fn(i); });
+	wait();
+}
+
+bool ThreadPool::popTask(unsigned int index, std::function<void()>& task)
+{
+	// Own deque first (LIFO, still warm in cache):
+	{
+		Worker& own = *m_workers[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// Then steal the oldest task of another worker:
+	for (size_t i = 1; i < m_workers.size(); ++i)
+	{
+		Worker& victim = *m_workers[(index + i) % m_workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::workerLoop(unsigned int index)
+{
+	while (true)
+	{
+		// Claim a queued task under the lock before looking for it. Workers that find nothing left to claim
+		// sleep on the condition instead of re-checking deques that other workers are emptying:
+		{
+			std::unique_lock<std::mutex> lock(m_stateMutex);
+			m_wakeCondition.wait(lock, [this] { return m_stop || m_queuedTasks > 0; });
+			if (m_stop)
+				return;
+			--m_queuedTasks;
+		}
+
+		// Tasks are pushed before they're counted and only popped once claimed, so one is always there for
+		// this claim. A pass can only miss it while a concurrent steal reshuffles which worker takes which:
+		std::function<void()> task;
+		while (!popTask(index, task))
+			std::this_thread::yield();
+
+		task();
+
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(m_stateMutex);
+			done = --m_pendingTasks == 0;
+		}
+		if (done)
+			m_doneCondition.notify_all();
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads, each with its own task deque. Workers take new work from the back
+// of their own deque and, once it is empty, steal from the front of the others', so uneven tasks (e.g.
+// image tiles that miss everything vs. ones full of geometry) balance out without a central queue.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void submit(std::function<void()> task);
+
+	// Block until every submitted task has finished:
+	void wait();
+
+	// Run fn(0) ... fn(count - 1) across the pool and wait for them all:
+	void parallelFor(int count, const std::function<void(int)>& fn);
+
+	unsigned int getThreadCount() const { return (unsigned int)m_threads.size(); }
+
+private:
+	struct Worker
+	{
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+	};
+
+	bool popTask(unsigned int index, std::function<void()>& task);
+	void workerLoop(unsigned int index);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_stateMutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	int m_queuedTasks{};		// Submitted but not yet taken by a worker.
+	int m_pendingTasks{};		// Submitted but not yet finished.
+	bool m_stop = false;
+
+	std::atomic<unsigned int> m_nextWorker{};
+};
@@ -0,0 +1,42 @@
+#include "VAO.h"
+#include "EBO.h"
+
+// Nothing draws with VAO or EBO at the moment, so this keeps them compiling. Each format's constructor is
+// instantiated for float data, and its stride and offsets checked against the attributes it lists:
+template VAO::VAO(std::span<const float>, VAO::Format::POS2, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS2_TEX2, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3_TEX2, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3_COL3, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3_COL3_TEX2, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3_TEX2_NORM3, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3_NORM3_TEX2, Buffer::Usage);
+template VAO::VAO(std::span<const float>, VAO::Format::POS3_NORM3_TEX2_PACKED, Buffer::Usage);
+
+static_assert(VAO::Format::POS2::STRIDE == 8);
+static_assert(VAO::Format::POS3::STRIDE == 12);
+
+static_assert(VAO::Format::POS2_TEX2::STRIDE == 16);
+static_assert(VAO::Format::POS2_TEX2::getOffset(1) == 8);
+
+static_assert(VAO::Format::POS3_TEX2::STRIDE == 20);
+static_assert(VAO::Format::POS3_TEX2::getOffset(1) == 12);
+
+static_assert(VAO::Format::POS3_COL3::STRIDE == 24);
+static_assert(VAO::Format::POS3_COL3::getOffset(1) == 12);
+
+static_assert(VAO::Format::POS3_COL3_TEX2::STRIDE == 32);
+static_assert(VAO::Format::POS3_COL3_TEX2::getOffset(1) == 12);
+static_assert(VAO::Format::POS3_COL3_TEX2::getOffset(2) == 24);
+
+static_assert(VAO::Format::POS3_TEX2_NORM3::STRIDE == 32);
+static_assert(VAO::Format::POS3_TEX2_NORM3::getOffset(1) == 12);
+static_assert(VAO::Format::POS3_TEX2_NORM3::getOffset(2) == 20);
+
+static_assert(VAO::Format::POS3_NORM3_TEX2::STRIDE == 32);
+static_assert(VAO::Format::POS3_NORM3_TEX2::getOffset(1) == 12);
+static_assert(VAO::Format::POS3_NORM3_TEX2::getOffset(2) == 24);
+
+static_assert(VAO::Format::POS3_NORM3_TEX2_PACKED::STRIDE == 20);
+static_assert(VAO::Format::POS3_NORM3_TEX2_PACKED::getOffset(1) == 12);
+static_assert(VAO::Format::POS3_NORM3_TEX2_PACKED::getOffset(2) == 16);
@@ -1,63 +1,74 @@
 #pragma once
-#include "GLObject.h"
+#include "Buffer.h"
+#include "VertexLayout.h"
 
-class VAO : public GLObject
+class VAO
 {
 public:
-	// The format of the VBO associated with this VAO.
-	enum class Format {
-		POS2,
-		POS3,
-		POS2_TEX2,
-		POS3_TEX2,
-		POS3_COL3,
-		POS3_COL3_TEX2,
-		POS3_TEX2_NORM3,
-		POS3_NORM3_TEX2
+	// Formats of the VBO associated with this VAO, passed as e.g. VAO::Format::POS2_TEX2():
+	struct Format
+	{
+		typedef VertexLayout<Pos2>					POS2;
+		typedef VertexLayout<Pos3>					POS3;
+		typedef VertexLayout<Pos2, Tex2>			POS2_TEX2;
+		typedef VertexLayout<Pos3, Tex2>			POS3_TEX2;
+		typedef VertexLayout<Pos3, Col3>			POS3_COL3;
+		typedef VertexLayout<Pos3, Col3, Tex2>		POS3_COL3_TEX2;
+		typedef VertexLayout<Pos3, Tex2, Norm3>		POS3_TEX2_NORM3;
+		typedef VertexLayout<Pos3, Norm3, Tex2>		POS3_NORM3_TEX2;
+		typedef VertexLayout<Pos3, Norm3Packed, Tex2Half>	POS3_NORM3_TEX2_PACKED;	// 20 bytes rather than 32.
 	};
 
-	VAO(const float data[], unsigned int size, Format format) {
-		glGenVertexArrays(1, &m_handle);
-		glBindVertexArray(m_handle);
+	// Vertices are any interleaved data matching the layout, e.g. a float array or a vertex struct:
+	template <typename T, typename... Attributes>
+	VAO(std::span<const T> vertices, VertexLayout<Attributes...>, Buffer::Usage usage = Buffer::Usage::STATIC) {
+		typedef VertexLayout<Attributes...> Layout;
 
-		// Create temporary VBO handle and generate + populate buffer:
-		glGenBuffers(1, &m_VBOhandle);
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBOhandle);
-		glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
-
-		switch (format)
-		{
-			case Format::POS3:
-				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-				glEnableVertexAttribArray(0);
-				break;
-			case Format::POS2_TEX2:
-				glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-				glEnableVertexAttribArray(0);
-				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-				glEnableVertexAttribArray(1);
-				break;
-			case Format::POS3_TEX2:
-				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-				glEnableVertexAttribArray(0);
-				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-				glEnableVertexAttribArray(1);
-				break;
-				// TODO: Add functionality for other buffer layouts
+		// Made by name where DSA is available, otherwise bound while the attributes are set:
+		m_VBO.init(GL_ARRAY_BUFFER, vertices, usage);
+		if (GLDsa::isAvailable()) {
+			GLuint name;
+			GLDsa::createVertexArrays(1, &name);
+			m_handle = VertexArrayHandle(name);
+			GLDsa::vertexArrayVertexBuffer(m_handle, 0, m_VBO.get(), 0, Layout::STRIDE);
+		}
+		else {
+			m_handle = VertexArrayHandle::create();
+			m_handle.bind();
+			m_VBO.bind();
 		}
-		glBindVertexArray(0);
+
+		for (GLuint i = 0; i < Layout::COUNT; ++i)
+			setAttribute(i, Layout::attributes[i], Layout::STRIDE, Layout::getOffset(i));
+
+		if (!GLDsa::isAvailable())
+			GLState::bindVertexArray(0);
 	}
-	~VAO() {
-		glDeleteVertexArrays(1, &m_handle);
-		glDeleteBuffers(1, &m_VBOhandle);
+	// Replace the vertex data from element 'first' on, for VBOs that aren't static:
+	template <typename T>
+	void update(std::span<const T> vertices, size_t first = 0) {
+		m_VBO.update(vertices, first);
 	}
-	void bind() {
-		glBindVertexArray(m_handle);
+	void bind() const {
+		m_handle.bind();
 	}
-	void unbind() {
-		glBindVertexArray(0);
+	void unbind() const {
+		GLState::bindVertexArray(0);
 	}
 private:
-	unsigned int m_VBOhandle;
+	void setAttribute(GLuint index, const VertexAttribute& attribute, GLsizei stride, GLuint offset) {
+		if (GLDsa::isAvailable()) {
+			GLDsa::vertexArrayAttribFormat(m_handle, index, attribute.components, attribute.type, attribute.normalised, offset);
+			GLDsa::vertexArrayAttribBinding(m_handle, index, 0);
+			GLDsa::enableVertexArrayAttrib(m_handle, index);
+		}
+		else {
+			glVertexAttribPointer(index, attribute.components, attribute.type, attribute.normalised, stride, (void*)(GLintptr)offset);
+			glEnableVertexAttribArray(index);
+		}
+	}
+
+	VertexArrayHandle m_handle;
+	Buffer m_VBO;
 };
 
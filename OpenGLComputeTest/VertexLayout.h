@@ -0,0 +1,48 @@
+#pragma once
+#include <glad4.3/glad4.3.h>
+
+// How one vertex attribute is stored. Integer types with 'normalised' set are read by the shader as floats
+// in [0, 1] or [-1, 1]:
+struct VertexAttribute
+{
+	GLint components;
+	GLenum type;
+	GLboolean normalised;
+	GLuint size;		// Bytes.
+};
+
+// Attribute kinds, in the order they usually appear in a layout:
+struct Pos2			{ static constexpr VertexAttribute attribute = { 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float) }; };
+struct Pos3			{ static constexpr VertexAttribute attribute = { 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float) }; };
+struct Norm3		{ static constexpr VertexAttribute attribute = { 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float) }; };
+struct Col3			{ static constexpr VertexAttribute attribute = { 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float) }; };
+struct Tex2			{ static constexpr VertexAttribute attribute = { 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float) }; };
+
+// Packed and compressed kinds. Pack with glm/gtc/packing.hpp, e.g. glm::packSnorm3x10_1x2() for a normal
+// and glm::packHalf2x16() for texture coordinates:
+struct Norm3Packed	{ static constexpr VertexAttribute attribute = { 4, GL_INT_2_10_10_10_REV, GL_TRUE, 4 }; };	// w ignored.
+struct Col4Unorm8	{ static constexpr VertexAttribute attribute = { 4, GL_UNSIGNED_BYTE, GL_TRUE, 4 }; };
+struct Tex2Half		{ static constexpr VertexAttribute attribute = { 2, GL_HALF_FLOAT, GL_FALSE, 4 }; };
+struct Tex2Unorm16	{ static constexpr VertexAttribute attribute = { 2, GL_UNSIGNED_SHORT, GL_TRUE, 4 }; };
+
+// Interleaved vertex made of the given attributes in order, at locations 0, 1, ..., with the offsets and
+// stride worked out at compile time. A CPU vertex struct can be checked against it with
+// static_assert(sizeof(Vertex) == VertexLayout<...>::STRIDE).
+template <typename... Attributes>
+struct VertexLayout
+{
+	static constexpr GLuint COUNT = sizeof...(Attributes);
+	static constexpr VertexAttribute attributes[] = { Attributes::attribute... };
+	static constexpr GLsizei STRIDE = (0 + ... + Attributes::attribute.size);
+
+	static constexpr GLuint getOffset(GLuint index)
+	{
+		GLuint offset = 0;
+		for (GLuint i = 0; i < index; ++i)
+			offset += attributes[i].size;
+		return offset;
+	}
+
+	// Unaligned attributes are slow or unsupported on some hardware:
+	static_assert(((Attributes::attribute.size % 4 == 0) && ...), "Vertex attributes must be a multiple of 4 bytes");
+};
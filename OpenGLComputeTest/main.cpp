@@ -1,6 +1,31 @@
 #include <iostream>
+#include <chrono>
+#include <algorithm>
 #include "Shader.h"
-#include "VAO.h"
+#include "FullscreenPass.h"
+#include "NoiseVolume.h"
+#include "MipGenerator.h"
+#include "TextureStats.h"
+#include "CpuRaymarcher.h"
+#include "ScatteringReference.h"
+#include "SdfScene.h"
+#include "SdfVolume.h"
+#include "CheckerboardResolve.h"
+#include "FroxelFog.h"
+#include "LightList.h"
+#include "LutFit.h"
+#include "LowRankLut.h"
+#include "LutArray.h"
+#include "LutRefitter.h"
+#include "SpectralLut.h"
+#include "LutWarp.h"
+#include "GpuTimer.h"
+#include "GLState.h"
+#include "GLDsa.h"
+#include "RingBuffer.h"
+#include "TextureLoader.h"
+#include "DynamicResolution.h"
+#include "Benchmark.h"
 #include <GLFW/glfw3.h>
 #include <imgui/imgui.h>
 #include <imgui/imgui_impl_glfw.h>
@@ -23,11 +48,43 @@ static bool GLLogCall(const char* func, const char* filename, int line)
 	return true;
 }
 
+// Render the raymarched scene on the CPU without creating a window:
+int runCpuRaymarch(int argc, char** argv);
+
+// Score each LUT method and resolution against a brute-force integration of the same model:
+int runLutBenchmark(int argc, char** argv);
+
+// Fit the LUTs with polynomials over a sweep of band counts and degrees, and factor them at increasing
+// ranks, reporting size and error. Then find how small each axis warp lets the LUTs get at the accuracy
+// of the unwarped ones:
+int runLutFit(int argc, char** argv);
+
 // Initialise GLFW and GLAD:
 GLFWwindow* initOpenGL();
 void initImGui(GLFWwindow* window);
 void processInput(GLFWwindow* window, float dt);
-void gui();
+void gui(const NoiseVolume& noiseVolume, const GpuTimer& raymarchTimer, SdfScene& sdfScene, const SdfVolume& sdfVolume, const GpuTimer& bakeTimer,
+	const GpuTimer& hooblerTimer, const GpuTimer& kovalovsTimer, const GpuTimer& spectralTimer, const GpuTimer& fogTimer,
+	const DynamicResolution& dynamicResolution, const RingBuffer& frameRing, TextureLoader& textureLoader);
+void warpGui(const char* label, AxisWarp& warp);
+RaymarchParams getRaymarchParams(const SdfScene& sdfScene, float time);
+FroxelFog::Params getFogParams(glm::ivec2 renderSize);
+SpectralLut::Params getSpectralLutParams(int bands);
+void setRaymarchUniforms(const Shader& shader, const RaymarchParams& params);
+void bakeHooblerLut(const Shader& accumShader, const Shader& sumShader, GLuint scatterAccumTex, GLuint accumLutTex, GLuint summedLutTex, glm::ivec2 size);
+void bakeKovalovsLut(const Shader& shader, GLuint lutTex, glm::ivec2 size, float gParam, int layer = 0);
+LutArray::Layout getKovalovsLutArrayLayout();
+bool updateKovalovsLutArray(const Shader& shader, LutArray& lutArray);
+void readLutTable(GLuint lutTex, bool hoobler, glm::ivec2 size, glm::ivec2 region, std::vector<float>& table);
+uint64_t getLutBakeKey(bool hoobler, glm::ivec2 region);
+
+// Warps the LUT tools try on both LUTs' distance (or radius) and angle axes, unwarped first:
+struct LutWarpConfig
+{
+	const char* name;
+	AxisWarp distance, angle;
+};
+std::vector<LutWarpConfig> getLutWarpConfigs();
 
 // LUT data:
 glm::vec3 g_wavelengths = glm::vec3(700, 530, 440);
@@ -38,19 +95,226 @@ float g_distance	= 10.0f;
 
 float g_vecLength	= 25.0f;
 float g_lightZFar	= 50.0f;
-glm::vec3 g_wavelengthDivisor = glm::vec3(1.0);
 
 float g_constant	= 1.0f;
 float g_linear		= 0.09f;
 float g_quadratic	= 0.032f;
 
+// Axis warps of each LUT, shared by its bake and everything that samples it (see res/lutWarp.glsl). The
+// first is the distance (Hoobler) or radius (Kovalovs) axis, the second the angle axis:
+AxisWarp g_hooblerWarps[2];
+AxisWarp g_kovalovsWarps[2];
+
+// Spectral Hoobler LUT, baked alongside the single-channel one and displayed in its place. Bands are spread
+// from the longest to the shortest of g_wavelengths, so three bands land on red, green and blue:
+bool g_spectralLut		= false;
+int g_spectralBands		= 3;
+int g_spectralDisplayLayer = 0;
+float g_spectralDivisor	= 200.0f;	// Band coefficients are g_scatterStrength * (divisor / wavelength)^4.
+
 bool g_KorH = false;			// 'false' = output Kovalovs' LUT, 'true' = output Hoobler's LUT.
 bool g_accumOrSum = false;		// 'false' = output accum LUT, 'true' = output summed LUT.
 
+// Noise data:
+bool g_displayNoise		= false;	// Show a z-slice of the noise volume instead of a LUT.
+bool g_animateNoise		= true;
+bool g_noiseRingMode	= true;		// 'true' = scroll a ring of z-slices, 'false' = regenerate the whole volume.
+float g_noiseFreq		= 0.05f;
+float g_noiseScrollSpeed = 1.0f;	// Noise units per second along z.
+float g_noiseSliceZ		= 0.5f;
+
+// Mip data:
+bool g_generateMips		= true;
+int g_mipFilter			= 0;		// Index into MipGenerator::Filter (box, max, min).
+float g_displayLod		= 0.0f;
+bool g_blitPresent		= true;		// Blit the displayed texture to the screen when it needs no shading.
+
+// Statistics data:
+bool g_autoNormalise	= true;		// Stretch the displayed texture over [0,1] using its min and max.
+bool g_autoLutScale		= true;		// Derive Hoobler's LUT encoding scale from the LUT's own maximum.
+float g_hooblerLutScale	= 32.0f / 32768.0f;
+TextureStats::Result g_displayStats{};
+float g_displayHistogram[TextureStats::HISTOGRAM_BINS]{};
+
+// Raymarch data:
+bool g_displayRaymarch	= false;	// Show the raymarched scene instead of a LUT.
+std::string g_scenePath	= "res/defaultScene.sdf";
+glm::vec3 g_cameraPos	= glm::vec3(0.0f, 1.5f, 0.0f);
+bool g_tileCulling		= true;		// Primary rays only evaluate the primitives listed for their tile.
+
+// Baked distance field:
+bool g_useBakedSdf		= false;	// Step through the baked volume, refining with the analytic scene near surfaces.
+int g_sdfResolution		= 128;		// Voxels along the longest side.
+float g_sdfBand			= 1.0f;
+bool g_rebakeSdf		= false;
+bool g_sdfCullSlabs		= true;		// Evaluate only the primitives that can reach each slab of voxels.
+bool g_rebakeSdfEveryFrame = false;	// For timing the bake.
+
+// Checkerboard tracing with temporal reprojection:
+bool g_checkerboard		= false;	// Trace half the pixels each frame and reproject the rest.
+float g_depthTolerance	= 0.05f;	// Relative depth difference beyond which history is rejected.
+
+// Sphere tracing policy:
+int g_maxSteps			= 100;
+float g_relaxation		= 1.0f;		// Over-relaxation factor, 1 = plain sphere tracing.
+float g_epsilon			= 0.01f;
+bool g_relativeEpsilon	= false;	// Scale the hit epsilon by distance along the ray.
+bool g_useBounds		= false;	// Bounding-sphere early-outs for the box and torus.
+int g_raymarchView		= 0;		// Shaded, steps per pixel heatmap or primitives per tile.
+float g_stepsPerPixel{};
+
+// Volumetric fog over the raymarched scene:
+bool g_fog				= false;
+int g_fogSource			= 0;		// Index into FroxelFog::Source (analytic, Kovalovs'/Hoobler's LUT or stand-ins).
+float g_fogDensity		= 0.05f;
+glm::vec3 g_fogAlbedo	= glm::vec3(0.9f);
+float g_fogHeightFalloff = 0.3f;
+float g_fogNoiseAmount	= 0.5f;
+glm::vec3 g_lightPos	= glm::vec3(0.0f, 3.0f, 6.0f);	// Key light, the one Hoobler's LUT is baked for.
+glm::vec3 g_lightColour	= glm::vec3(20.0f);
+float g_lightRange		= 10.0f;	// Distance at which the key light fades out, the edge of Kovalovs' LUT.
+int g_lightCount		= 256;		// Random point and spot lights besides the key light.
+bool g_perLightG		= false;	// Random lights scatter with their own g rather than g_gParam.
+
+// Polynomial fits and low-rank factorisations standing in for the LUTs, made when first used and redone when
+// their LUT changes or on request. Both are redone in the background at most once an interval:
+int g_fitBands			= 16;
+int g_fitDegreeU		= 5;
+int g_fitDegreeV		= 2;
+int g_lowRank			= 8;
+bool g_refitLut			= false;
+float g_refitInterval	= LutRefitter::DEFAULT_INTERVAL;	// Seconds.
+float g_fitRmse{};
+float g_fitMaxError{};
+
+// Kovalovs' LUT pre-baked over g for the LUT array source. Loaded from the cache at startup when it was
+// saved with the same parameters, and rebaked whenever they change:
+int g_lutArrayLayers	= 32;
+int g_lutArraySize		= 256;
+float g_lutArrayGMin	= -0.95f;
+float g_lutArrayGMax	= 0.95f;
+bool g_animateG			= false;	// Sweep g across the array's range.
+const char* LUT_ARRAY_CACHE_PATH = "kovalovsLutArray.cache";
+
+// Dynamic resolution:
+bool g_dynamicResolution	= true;		// Scale the LUT and raymarch passes to keep their GPU time inside the budget.
+float g_computeBudgetMs		= 4.0f;
+float g_minResolutionScale	= 0.25f;
+
+// CPU reference data:
+bool g_renderCpuReference = false;
+int g_cpuPacketWidth	= 8;
+float g_cpuRenderMs{}, g_cpuRmse{}, g_cpuMaxError{};
+
+// GL object setup and binding cache:
+bool g_useDsa		= true;		// Create objects through GL 4.5 direct state access when the context has it.
+bool g_elideGlState	= true;		// Drop binds that match the current GL state.
+GLState::Counters g_glStateCounters;	// Last frame's issued and elided calls.
+
+// Textures loaded from files, by --texture or through the GUI:
+std::vector<std::string> g_texturePaths;
+char g_textureLoadPath[256]{};
+
 const int WIDTH = 1024, HEIGHT = 1024, DEPTH = 50;
+const int NOISE_WIDTH = 128, NOISE_HEIGHT = 128, NOISE_DEPTH = 128;
+const int FROXEL_WIDTH = 160, FROXEL_HEIGHT = 90, FROXEL_DEPTH = 64;
+const int FRAME_RING_SIZE = 64 * 1024;		// Bytes per frame.
 
-int main()
+int main(int argc, char** argv)
 {
+	// Pull out options shared by every mode:
+	int argCount = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == "--scene" && i + 1 < argc)
+			g_scenePath = argv[++i];
+		else if (std::string(argv[i]) == "--no-dsa")
+			g_useDsa = false;
+		else if (std::string(argv[i]) == "--texture" && i + 1 < argc)
+			g_texturePaths.push_back(argv[++i]);
+		else
+			argv[argCount++] = argv[i];
+	}
+	argc = argCount;
+
+	if (argc > 1 && std::string(argv[1]) == "--cpu-raymarch")
+		return runCpuRaymarch(argc, argv);
+	if (argc > 1 && std::string(argv[1]) == "--lut-benchmark")
+		return runLutBenchmark(argc, argv);
+	if (argc > 1 && std::string(argv[1]) == "--lut-fit")
+		return runLutFit(argc, argv);
+
+	// Compare sphere tracing policies on the GPU, printing a table and exiting when done:
+	Benchmark benchmark;
+	if (argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		struct RaymarchConfig
+		{
+			const char* name;
+			float relaxation;
+			bool bounds, relativeEpsilon, tileCulling, bakedSdf, checkerboard;
+			int fogSource;	// FroxelFog::Source, or -1 for no fog.
+			int lightCount;
+		};
+		const RaymarchConfig configs[] = {
+			{ "Plain sphere tracing",				1.0f, false, false, true,  false, false, -1, 0 },
+			{ "Over-relaxed",						1.6f, false, false, true,  false, false, -1, 0 },
+			{ "Over-relaxed + bounds",				1.6f, true,  false, true,  false, false, -1, 0 },
+			{ "Over-relaxed + bounds + rel. eps",	1.6f, true,  true,  true,  false, false, -1, 0 },
+			{ "Same, without tile culling",			1.6f, true,  true,  false, false, false, -1, 0 },
+			{ "Same, with culling + baked SDF",		1.6f, true,  true,  true,  true,  false, -1, 0 },
+			{ "Same, + checkerboard",				1.6f, true,  true,  true,  true,  true,  -1, 0 },
+			{ "Same, + fog (analytic)",				1.6f, true,  true,  true,  true,  true,  0,  0 },
+			{ "Same, + 256 lights",					1.6f, true,  true,  true,  true,  true,  0,  256 },
+			{ "Same, + 2048 lights",				1.6f, true,  true,  true,  true,  true,  0,  2048 },
+			{ "Same, + fog (Kovalovs LUT)",			1.6f, true,  true,  true,  true,  true,  1,  0 },
+			{ "Same, + fog (Hoobler LUT)",			1.6f, true,  true,  true,  true,  true,  2,  0 },
+			{ "Same, + fog (Kovalovs fit)",			1.6f, true,  true,  true,  true,  true,  3,  0 },
+			{ "Same, + fog (Hoobler fit)",			1.6f, true,  true,  true,  true,  true,  4,  0 },
+			{ "Same, + fog (Hoobler low rank)",		1.6f, true,  true,  true,  true,  true,  5,  0 },
+			{ "Same, + fog (Kovalovs LUT array)",	1.6f, true,  true,  true,  true,  true,  6,  0 },
+		};
+		for (const RaymarchConfig& config : configs)
+		{
+			benchmark.addConfig(config.name, [config]()
+			{
+				g_relaxation		= config.relaxation;
+				g_useBounds			= config.bounds;
+				g_relativeEpsilon	= config.relativeEpsilon;
+				g_tileCulling		= config.tileCulling;
+				g_useBakedSdf		= config.bakedSdf;
+				g_checkerboard		= config.checkerboard;
+				g_fog				= config.fogSource >= 0;
+				g_fogSource			= config.fogSource >= 0 ? config.fogSource : 0;
+				g_lightCount		= config.lightCount;
+				g_sdfCullSlabs		= true;
+				g_rebakeSdfEveryFrame = false;
+			});
+		}
+
+		// Bake cost, rebaking every frame with and without culling primitives per slab. Their march times
+		// are the baked SDF row's plus the bake, so compare that row against the analytic ones above:
+		for (bool cullSlabs : { true, false })
+		{
+			benchmark.addConfig(cullSlabs ? "Baked SDF, rebaked per slab" : "Baked SDF, rebaked in full", [cullSlabs]()
+			{
+				g_relaxation		= 1.6f;
+				g_useBounds			= true;
+				g_relativeEpsilon	= true;
+				g_tileCulling		= true;
+				g_useBakedSdf		= true;
+				g_checkerboard		= false;
+				g_fog				= false;
+				g_lightCount		= 0;
+				g_sdfCullSlabs		= cullSlabs;
+				g_rebakeSdfEveryFrame = true;
+			});
+		}
+		g_displayRaymarch = true;
+		g_dynamicResolution = false;
+		benchmark.start();
+	}
+
 	GLFWwindow* window = initOpenGL();
 	if (!window)
 		return -1;
@@ -59,203 +323,564 @@ int main()
 
 	std::cout << "Hello, world!\n" << glGetString(GL_VERSION) << std::endl;
 
-	Shader fullscreenShader;
-	Shader hooblerAccumLutShader;
-	Shader hooblerSumLutShader;
-	Shader kovalovsLutShader;
+	// Scoped so the GL objects are deleted before the context is destroyed:
+	{
+		Shader fullscreenShader;
+		Shader hooblerAccumLutShader;
+		Shader hooblerSumLutShader;
+		Shader kovalovsLutShader;
+		Shader raymarchShader;
+		Shader raymarchCheckerShader;
 
-	fullscreenShader.loadShader("res/fullscreenShader_vertex.vert", "res/fullscreenShader_frag.frag");
-	hooblerAccumLutShader.loadShader("res/hooblerAccumLUTShader.comp");
-	hooblerSumLutShader.loadShader("res/hooblerSumLUTShader.comp");
-	kovalovsLutShader.loadShader("res/kovalovsLUTShader.comp");
+		fullscreenShader.loadShader(FullscreenPass::VERTEX_SHADER_PATH, "res/fullscreenShader_frag.frag");
+		hooblerAccumLutShader.loadShader("res/hooblerAccumLUTShader.comp");
+		hooblerSumLutShader.loadShader("res/hooblerSumLUTShader.comp");
+		kovalovsLutShader.loadShader("res/kovalovsLUTShader.comp");
+		raymarchShader.loadShader("res/raymarchComputeShader.comp", SdfScene::getShaderDefines());
+		raymarchCheckerShader.loadShader("res/raymarchComputeShader.comp", SdfScene::getShaderDefines() + "#define CHECKERBOARD\n");
 
-	fullscreenShader.use();
-	fullscreenShader.setInt("u_lutTex", 0);
+		fullscreenShader.use();
+		fullscreenShader.setInt("u_lutTex", 0);
+		fullscreenShader.setInt("u_noiseTex", 1);
 
 #pragma region TextureSetup
-	// Final output of Hoobler's LUT calculations:
-	GLuint hooblerAccumLutTex;
-	glGenTextures(1, &hooblerAccumLutTex);
-	glBindTexture(GL_TEXTURE_2D, hooblerAccumLutTex);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, WIDTH, HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
-
-	// Final output of Kovalovs' LUT calculations:
-	GLuint kovalovsLutTex;
-	glGenTextures(1, &kovalovsLutTex);
-	glBindTexture(GL_TEXTURE_2D, kovalovsLutTex);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, WIDTH, HEIGHT, 0, GL_RED, GL_FLOAT, NULL);
-
-	// Intermediate buffer used in Hoobler's LUT calculations:
-	GLuint scatterAccumTex;
-	glGenTextures(1, &scatterAccumTex);
-	glBindTexture(GL_TEXTURE_2D, scatterAccumTex);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, WIDTH, HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
-
-	// Results after sum pass for Hoobler's LUT calculations:
-	GLuint hooblerSummedLutTex;
-	glGenTextures(1, &hooblerSummedLutTex);
-	glBindTexture(GL_TEXTURE_2D, hooblerSummedLutTex);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, WIDTH, HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
+		// Displayed LUTs get a full mip chain, built after every bake by the mip generator:
+		const int lutLevels = MipGenerator::getLevelCount(WIDTH, HEIGHT);
+
+		// Final output of Hoobler's LUT calculations:
+		TextureHandle hooblerAccumLutTex = GLDsa::createTexture2D(GL_RGBA32F, WIDTH, HEIGHT, lutLevels, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+
+		// Final output of Kovalovs' LUT calculations:
+		TextureHandle kovalovsLutTex = GLDsa::createTexture2D(GL_R32F, WIDTH, HEIGHT, lutLevels, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+
+		// Intermediate buffer used in Hoobler's LUT calculations:
+		TextureHandle scatterAccumTex = GLDsa::createTexture2D(GL_RGBA32F, WIDTH, HEIGHT, 1, GL_LINEAR, GL_LINEAR);
+
+		// Results after sum pass for Hoobler's LUT calculations:
+		TextureHandle hooblerSummedLutTex = GLDsa::createTexture2D(GL_RGBA32F, WIDTH, HEIGHT, lutLevels, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+
+		// Output of the raymarcher:
+		TextureHandle raymarchTex = GLDsa::createTexture2D(GL_RGBA32F, WIDTH, HEIGHT, 1, GL_LINEAR, GL_LINEAR);
+
+		// Steps taken per pixel by the raymarcher, averaged by the statistics pass:
+		TextureHandle raymarchStepsTex = GLDsa::createTexture2D(GL_R32F, WIDTH, HEIGHT, 1, GL_NEAREST, GL_NEAREST);
+
+		// Distance along each primary ray, for reprojecting the checkerboard's skipped pixels:
+		TextureHandle raymarchDepthTex = GLDsa::createTexture2D(GL_R32F, WIDTH, HEIGHT, 1, GL_NEAREST, GL_NEAREST);
+
+		CheckerboardResolve checkerboardResolve;
+		checkerboardResolve.init(WIDTH, HEIGHT);
+		int checkerParity = 0;
+		int resolvedSceneVersion = -1;
+
+		GpuTimer raymarchTimer;
+		GpuTimer hooblerTimer;
+		GpuTimer kovalovsTimer;
+		raymarchTimer.init();
+		hooblerTimer.init();
+		kovalovsTimer.init();
+
+		// Size the LUT and raymarch passes render at, within the full-size textures:
+		DynamicResolution dynamicResolution(WIDTH, HEIGHT);
+
+		// Primitives traced by the raymarcher:
+		SdfScene sdfScene;
+		sdfScene.init();
+		if (!sdfScene.loadFromFile(g_scenePath.c_str()))
+			std::cout << "Raymarching an empty scene." << std::endl;
+		sdfScene.upload();
+
+		// Baked when first used and whenever the scene changes:
+		SdfVolume sdfVolume;
+		sdfVolume.init();
+		GpuTimer bakeTimer;
+		bakeTimer.init();
+
+		// CPU mirror of the raymarcher, used as a golden reference:
+		ThreadPool threadPool;
+		CpuRaymarcher cpuRaymarcher(threadPool);
+
+		MipGenerator mipGenerator;
+		mipGenerator.init();
+
+		// Statistics of the displayed texture, and of Hoobler's LUT for its encoding scale:
+		TextureStats displayStats;
+		TextureStats hooblerStats;
+		TextureStats stepsStats;
+		displayStats.init();
+		hooblerStats.init();
+		stepsStats.init();
+
+		// Per-frame uniform, storage and indirect data:
+		RingBuffer frameRing;
+		if (!frameRing.init(FRAME_RING_SIZE))
+			std::cout << "Persistent mapping unavailable, per-frame data goes through buffer updates." << std::endl;
+
+		// Decoded on a pool of its own so parallelFor() on the main pool never waits on a decode:
+		ThreadPool assetPool(2);
+		TextureLoader textureLoader(assetPool);
+		textureLoader.init();
+		for (const std::string& path : g_texturePaths)
+			textureLoader.load(path);
+
+		// Froxel fog, and the passes' total cost so the LUT sources can be compared:
+		FroxelFog froxelFog;
+		froxelFog.init(FROXEL_WIDTH, FROXEL_HEIGHT, FROXEL_DEPTH);
+		GpuTimer fogTimer;
+		fogTimer.init();
+
+		// Spectral Hoobler LUT, and the layer of it on display:
+		SpectralLut spectralLut;
+		spectralLut.init();
+		GpuTimer spectralTimer;
+		spectralTimer.init();
+
+		TextureHandle spectralDisplayTex = GLDsa::createTexture2D(GL_RGBA32F, WIDTH, HEIGHT, 1, GL_LINEAR, GL_LINEAR);
+
+		// Fitted on a pool of its own, so the fits' parallelFor() on the main pool never waits on the job:
+		ThreadPool refitPool(1);
+		LutRefitter lutRefitter(refitPool, threadPool);
+		lutRefitter.init();
+
+		LutArray kovalovsLutArray;
+		kovalovsLutArray.init();
+		if (!kovalovsLutArray.load(LUT_ARRAY_CACHE_PATH, getKovalovsLutArrayLayout()))
+		{
+			updateKovalovsLutArray(kovalovsLutShader, kovalovsLutArray);
+			kovalovsLutArray.save(LUT_ARRAY_CACHE_PATH);
+		}
+		bool lutArrayUnsaved = false;
+
+		// The key light followed by random lights through the scene, regenerated when their count changes:
+		LightList lightList;
+		lightList.init();
+		std::vector<LightList::Light> randomLights;
+
+		// Animated 3D noise:
+		NoiseVolume noiseVolume;
+		noiseVolume.init(NOISE_WIDTH, NOISE_HEIGHT, NOISE_DEPTH);
+		noiseVolume.generateFull(g_noiseFreq, 0.0f);
 #pragma endregion
 #pragma region PrintComputeDetails
-	{
-		// Print max number of worker groups:
-		int workGroupCount[3];
-		for (int i = 0; i < 3; ++i)
-			glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, i, &workGroupCount[i]);
-		printf("\nMax global (total) work group counts: (%i, %i, %i)\n",
-			workGroupCount[0], workGroupCount[1], workGroupCount[2]);
-
-		// Print max size of a worker group:
-		int workGroupSize[3];
-		for (int i = 0; i < 3; ++i)
-			glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, i, &workGroupSize[i]);
-		printf("Max local (in one shader) work group sizes: (%i, %i, %i)\n",
-			workGroupSize[0], workGroupSize[1], workGroupSize[2]);
-
-		// Print max number of worker group invocations:
-		int workGroupInvocations;
-		glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &workGroupInvocations);
-		printf("Max local work group invocations: %i\n", workGroupInvocations);
-	}
+		{
+			// Print max number of worker groups:
+			int workGroupCount[3];
+			for (int i = 0; i < 3; ++i)
+				glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, i, &workGroupCount[i]);
+			printf("\nMax global (total) work group counts: (%i, %i, %i)\n",
+				workGroupCount[0], workGroupCount[1], workGroupCount[2]);
+
+			// Print max size of a worker group:
+			int workGroupSize[3];
+			for (int i = 0; i < 3; ++i)
+				glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, i, &workGroupSize[i]);
+			printf("Max local (in one shader) work group sizes: (%i, %i, %i)\n",
+				workGroupSize[0], workGroupSize[1], workGroupSize[2]);
+
+			// Print max number of worker group invocations:
+			int workGroupInvocations;
+			glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &workGroupInvocations);
+			printf("Max local work group invocations: %i\n", workGroupInvocations);
+		}
 #pragma endregion
 
-	// Bind raymarching texture:
-	float fullscreenQuad[] = {
-		// (Described as NDC coords)
-		// positions   // texCoords
-		-1.0f,  1.0f,  0.0f, 1.0f,
-		-1.0f, -1.0f,  0.0f, 0.0f,
-		 1.0f, -1.0f,  1.0f, 0.0f,
-
-		-1.0f,  1.0f,  0.0f, 1.0f,
-		 1.0f, -1.0f,  1.0f, 0.0f,
-		 1.0f,  1.0f,  1.0f, 1.0f
-	};
-	VAO fullscreenVAO(fullscreenQuad, sizeof(fullscreenQuad), VAO::Format::POS2_TEX2);
-	
-	float dt{}, lastFrame{};
+		// Draws the display pass, or blits straight to the screen:
+		FullscreenPass fullscreenPass;
+		fullscreenPass.init();
+		
+		float dt{}, lastFrame{};
 
-	std::string renderDebugText		= std::string("Rendering");
-	std::string hooblerDebugText	= std::string("Hoobler LUT pass");
-	std::string kovalovsDebugText	= std::string("Kovalovs LUT pass");
-	std::string fullscreenDebugText = std::string("Fullscreen quad pass");
-	std::string guiDebugText		= std::string("GUI pass");
+		std::string renderDebugText		= std::string("Rendering");
+		std::string hooblerDebugText	= std::string("Hoobler LUT pass");
+		std::string kovalovsDebugText	= std::string("Kovalovs LUT pass");
+		std::string spectralDebugText	= std::string("Spectral LUT pass");
+		std::string raymarchDebugText	= std::string("Raymarch pass");
+		std::string fogDebugText		= std::string("Froxel fog pass");
+		std::string noiseDebugText		= std::string("Noise pass");
+		std::string mipDebugText		= std::string("Mip generation pass");
+		std::string statsDebugText		= std::string("Texture statistics pass");
+		std::string fullscreenDebugText = std::string("Fullscreen quad pass");
+		std::string guiDebugText		= std::string("GUI pass");
 
-	float time{};
+		float time{};
+		bool hooblerBaked = true, kovalovsBaked = true;		// Last frame, so skipped bakes drop out of the rescale.
 
-	while (!glfwWindowShouldClose(window))
-	{
-		// Start new ImGui frame:
-		ImGui_ImplGlfw_NewFrame();
-		ImGui_ImplOpenGL3_NewFrame();
-		ImGui::NewFrame();
+		while (!glfwWindowShouldClose(window))
+		{
+			if (benchmark.isRunning() && !benchmark.beginFrame())
+			{
+				glfwSetWindowShouldClose(window, true);
+				break;
+			}
 
-		float currentFrame = glfwGetTime();
-		dt = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+			// Take last frame's bind counts before this one's start:
+			g_glStateCounters = GLState::getCounters();
+			GLState::resetCounters();
+			GLState::setElisionEnabled(g_elideGlState);
+			benchmark.record("GL binds issued", (float)g_glStateCounters.getIssued());
+			benchmark.record("GL binds elided", (float)g_glStateCounters.getElided());
 
-		processInput(window, dt);
+			// Last frame's ring usage, then on to the next region:
+			benchmark.record("Frame ring bytes", (float)frameRing.getUsed());
+			frameRing.beginFrame();
 
-		glClearColor(1.0f, 0.5f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
+			// Upload whatever finished decoding, as far as the free staging buffers allow:
+			textureLoader.update();
 
-		// Rendering debug group:
-		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, renderDebugText.size(), renderDebugText.c_str());
-		{
-			// Hoobler LUT shader stuffs:
-			glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, hooblerDebugText.size(), hooblerDebugText.c_str());
+			// Swap in whatever LUT fit or factors finished in the background:
+			lutRefitter.setInterval(g_refitInterval);
+			if (lutRefitter.update())
 			{
-				// Calculate scattering coefficients based on wavelengths:
-				glm::vec3 scatteringCoefficients = glm::vec3(g_scatterStrength);
-				scatteringCoefficients.x *= powf(g_wavelengthDivisor.x / g_wavelengths.x, 4);
-				scatteringCoefficients.y *= powf(g_wavelengthDivisor.y / g_wavelengths.y, 4);
-				scatteringCoefficients.z *= powf(g_wavelengthDivisor.z / g_wavelengths.z, 4);
-
-				hooblerAccumLutShader.use();
-				hooblerAccumLutShader.setVec3("u_scatteringCoefficients", scatteringCoefficients);
-				hooblerAccumLutShader.setFloat("u_tau", g_tau);
-				hooblerAccumLutShader.setFloat("u_distance", g_distance);
-				hooblerAccumLutShader.setFloat("u_gParam", g_gParam);
-
-				hooblerAccumLutShader.setFloat("u_vecLength", g_vecLength);
-				hooblerAccumLutShader.setFloat("u_lightZFar", g_lightZFar);
-
-				hooblerAccumLutShader.setFloat("u_constant", g_constant);
-				hooblerAccumLutShader.setFloat("u_linear", g_linear);
-				hooblerAccumLutShader.setFloat("u_quadratic", g_quadratic);
-
-				glBindImageTexture(3, scatterAccumTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
-				glBindImageTexture(4, hooblerAccumLutTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
-				glBindImageTexture(5, hooblerSummedLutTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
-				glDispatchCompute(32, 128, 1);
+				g_fitRmse = lutRefitter.getRmse();
+				g_fitMaxError = lutRefitter.getMaxError();
+			}
 
-				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+			// Collect statistics read back from earlier frames:
+			TextureStats::Result hooblerResult;
+			if (hooblerStats.poll(hooblerResult))
+			{
+				// LUT stores raw / scale in RGB and the scale it was baked with in A:
+				float encodedMax = glm::max(hooblerResult.maxVal.r, glm::max(hooblerResult.maxVal.g, hooblerResult.maxVal.b));
+				float rawMax = encodedMax * hooblerResult.maxVal.a;
+				if (g_autoLutScale && rawMax > 0.0f && std::isfinite(rawMax))
+					g_hooblerLutScale = rawMax;
+			}
+
+			if (displayStats.poll(g_displayStats))
+				for (int i = 0; i < TextureStats::HISTOGRAM_BINS; ++i)
+					g_displayHistogram[i] = (float)g_displayStats.histogram[i];
 
-				hooblerSumLutShader.use();
-				glDispatchCompute(32, 256, 1);
+			TextureStats::Result stepsResult;
+			if (stepsStats.poll(stepsResult))
+			{
+				g_stepsPerPixel = stepsResult.mean.r;
+				benchmark.record("Steps per pixel", g_stepsPerPixel);
 			}
-			glPopDebugGroup();
 
-			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+			bool newTiming = false;
+			if (hooblerTimer.poll())
+			{
+				benchmark.record("Hoobler LUT GPU ms", hooblerTimer.getMilliseconds());
+				newTiming = true;
+			}
+			if (kovalovsTimer.poll())
+			{
+				benchmark.record("Kovalovs LUT GPU ms", kovalovsTimer.getMilliseconds());
+				newTiming = true;
+			}
+			if (raymarchTimer.poll())
+			{
+				benchmark.record("Raymarch GPU ms", raymarchTimer.getMilliseconds());
+				newTiming = true;
+			}
+			if (fogTimer.poll())
+				benchmark.record("Fog GPU ms", fogTimer.getMilliseconds());
+			spectralTimer.poll();
+			if (bakeTimer.poll())
+				benchmark.record("SDF bake GPU ms", bakeTimer.getMilliseconds());
 
-			// Kovalovs LUT shader stuffs:
-			glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, kovalovsDebugText.size(), kovalovsDebugText.c_str());
+			// Rescale from the latest timings of the scaled passes. The raymarcher only counts while it runs:
+			if (!g_dynamicResolution)
+				dynamicResolution.reset();
+			else if (newTiming)
 			{
-				kovalovsLutShader.use();
-				kovalovsLutShader.setFloat("u_gParam", g_gParam);
+				const float lutMs = (hooblerBaked ? hooblerTimer.getMilliseconds() : 0.0f) + (kovalovsBaked ? kovalovsTimer.getMilliseconds() : 0.0f);
+				const float computeMs = lutMs + (g_displayRaymarch ? raymarchTimer.getMilliseconds() : 0.0f);
+				dynamicResolution.setMinScale(g_minResolutionScale);
+				dynamicResolution.update(computeMs, g_computeBudgetMs);
+			}
+
+			// The CPU reference is compared against a full-size frame:
+			const glm::ivec2 renderSize = g_renderCpuReference ? glm::ivec2(WIDTH, HEIGHT) : dynamicResolution.getSize();
+
+			// Start new ImGui frame:
+			ImGui_ImplGlfw_NewFrame();
+			ImGui_ImplOpenGL3_NewFrame();
+			ImGui::NewFrame();
+
+			float currentFrame = glfwGetTime();
+			dt = currentFrame - lastFrame;
+			lastFrame = currentFrame;
+
+			processInput(window, dt);
+
+			if (g_animateG)
+				g_gParam = glm::mix(g_lutArrayGMin, g_lutArrayGMax, 0.5f + 0.5f * sinf(currentFrame));
+
+			glClearColor(1.0f, 0.5f, 0.0f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+
+			// Rendering debug group:
+			glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, renderDebugText.size(), renderDebugText.c_str());
+			{
+				// Hoobler's LUT is only valid for one light distance, so follow the fogged scene's light:
+				const bool fog = g_fog && g_displayRaymarch && !g_renderCpuReference;
+				const FroxelFog::Source fogSource = (FroxelFog::Source)g_fogSource;
+				const bool hooblerFog = fogSource == FroxelFog::Source::HOOBLER_LUT || fogSource == FroxelFog::Source::HOOBLER_FIT
+					|| fogSource == FroxelFog::Source::HOOBLER_LOW_RANK;
+				if (fog && hooblerFog)
+					g_vecLength = glm::length(g_lightPos - g_cameraPos);
+
+				// Fits and factors stand in for the fog's LUT once the first is done, and are only redone on
+				// request or once the LUT has changed, which for Hoobler's is whenever the camera moves. They
+				// read the LUT back, so it is only baked for a refit rather than every frame:
+				const bool fitSource = fogSource == FroxelFog::Source::KOVALOVS_FIT || fogSource == FroxelFog::Source::HOOBLER_FIT;
+				const bool lowRankSource = fogSource == FroxelFog::Source::HOOBLER_LOW_RANK;
+				const bool standIn = fog && (fitSource || lowRankSource);
+				const LutRefitter::Target refitTarget = lowRankSource ? LutRefitter::Target::HOOBLER_LOW_RANK
+					: hooblerFog ? LutRefitter::Target::HOOBLER_FIT : LutRefitter::Target::KOVALOVS_FIT;
+				const uint64_t bakeKey = getLutBakeKey(hooblerFog, renderSize);
+				const uint64_t refitKey = lowRankSource ? LutArray::hash(&g_lowRank, sizeof(g_lowRank), bakeKey) : bakeKey;
+				const bool refitDue = standIn && lutRefitter.isRefitDue(refitTarget, refitKey, g_refitLut);
+				const bool standInReady = lowRankSource ? lutRefitter.getLowRank() != nullptr : lutRefitter.getFit(refitTarget) != nullptr;
+				const bool skipLutBake = standIn && standInReady && !refitDue;
+				hooblerBaked = !(skipLutBake && hooblerFog);
+				kovalovsBaked = !(skipLutBake && !hooblerFog);
+
+				// Hoobler LUT shader stuffs:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, hooblerDebugText.size(), hooblerDebugText.c_str());
+				if (hooblerBaked)
+				{
+					hooblerTimer.begin();
+					bakeHooblerLut(hooblerAccumLutShader, hooblerSumLutShader, scatterAccumTex, hooblerAccumLutTex, hooblerSummedLutTex, renderSize);
+					hooblerTimer.end();
+				}
+				glPopDebugGroup();
+
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+				// Kovalovs LUT shader stuffs:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, kovalovsDebugText.size(), kovalovsDebugText.c_str());
+				if (kovalovsBaked)
+				{
+					kovalovsTimer.begin();
+					bakeKovalovsLut(kovalovsLutShader, kovalovsLutTex, renderSize, g_gParam);
+					kovalovsTimer.end();
+				}
+				glPopDebugGroup();
+
+				// Every band of the spectral LUT in one pass, then the layer on display copied out:
+				if (g_spectralLut)
+				{
+					glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, spectralDebugText.size(), spectralDebugText.c_str());
+					spectralTimer.begin();
+					spectralLut.bake(getSpectralLutParams(g_spectralBands), renderSize);
+					spectralTimer.end();
+
+					const int layer = glm::clamp(g_spectralDisplayLayer, 0, spectralLut.getLayerCount() - 1);
+					glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+					glCopyImageSubData(spectralLut.getSummedTexture(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer,
+						spectralDisplayTex, GL_TEXTURE_2D, 0, 0, 0, 0, renderSize.x, renderSize.y, 1);
+					glPopDebugGroup();
+				}
+
+				// Raymarching stuffs:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, raymarchDebugText.size(), raymarchDebugText.c_str());
+				if (g_displayRaymarch || g_renderCpuReference)
+				{
+					if (g_useBakedSdf && (g_rebakeSdf || g_rebakeSdfEveryFrame || sdfVolume.getBakedSceneVersion() != sdfScene.getVersion()))
+					{
+						bakeTimer.begin();
+						sdfVolume.bake(sdfScene, g_sdfResolution, g_sdfBand, g_sdfCullSlabs);
+						bakeTimer.end();
+						g_rebakeSdf = false;
+					}
+
+					sdfScene.cullTiles(g_cameraPos, renderSize.x, renderSize.y, g_tileCulling);
 
-				kovalovsLutShader.setFloat("u_constant", g_constant);
-				kovalovsLutShader.setFloat("u_linear", g_linear);
-				kovalovsLutShader.setFloat("u_quadratic", g_quadratic);
+					// History is stale once the scene changes or frames stop being resolved. The CPU reference
+					// compares against a fully traced frame:
+					const bool checkerboard = g_checkerboard && !g_renderCpuReference;
+					if (!checkerboard || sdfScene.getVersion() != resolvedSceneVersion)
+						checkerboardResolve.invalidate();
+					resolvedSceneVersion = sdfScene.getVersion();
+					checkerParity ^= 1;
 
-				glBindImageTexture(6, kovalovsLutTex, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
-				glDispatchCompute(1, HEIGHT, 1);
+					const Shader& shader = checkerboard ? raymarchCheckerShader : raymarchShader;
+					shader.use();
+					setRaymarchUniforms(shader, getRaymarchParams(sdfScene, currentFrame));
+					shader.setInt("u_primitiveCount", sdfScene.getPrimitiveCount());
+					shader.setInt("u_checkerParity", checkerParity);
+					shader.setVec2("u_frameSize", glm::vec2(renderSize));
+					shader.setBool("u_useBakedSdf", g_useBakedSdf && sdfVolume.isBaked());
+					sdfVolume.setUniforms(shader, 0);
+					sdfScene.bind();
+
+					GLState::bindImageTexture(0, raymarchTex, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+					GLState::bindImageTexture(1, raymarchStepsTex, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+					GLState::bindImageTexture(3, raymarchDepthTex, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+					raymarchTimer.begin();
+					glDispatchCompute(renderSize.x / SdfScene::TILE_SIZE, renderSize.y / SdfScene::TILE_SIZE, 1);
+					if (checkerboard)
+						checkerboardResolve.resolve(raymarchTex, raymarchDepthTex, renderSize.x, renderSize.y, g_cameraPos, checkerParity, g_depthTolerance);
+					raymarchTimer.end();
+
+					glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+					stepsStats.compute(raymarchStepsTex, renderSize.x, renderSize.y);
+				}
+				glPopDebugGroup();
+
+				// Volumetric fog, composited over the raymarched frame by its hit distances:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, fogDebugText.size(), fogDebugText.c_str());
+				if (fog)
+				{
+					FroxelFog::Table fogTable;
+					fogTable.lut = hooblerFog ? hooblerSummedLutTex : kovalovsLutTex;
+					fogTable.lutUvScale = glm::vec2(renderSize) / glm::vec2(WIDTH, HEIGHT);
+
+					// The fog keeps the last fit or factors while the next are made, and samples the LUT itself
+					// until the first are done:
+					FroxelFog::Params fogParams = getFogParams(renderSize);
+					if (standIn)
+					{
+						if (refitDue)
+						{
+							const LutRefitter::Settings settings = { g_fitBands, g_fitDegreeU, g_fitDegreeV, g_lowRank };
+							lutRefitter.refit(refitTarget, refitKey, fogTable.lut, glm::ivec2(WIDTH, HEIGHT), renderSize, settings);
+							g_refitLut = false;
+						}
+						if (lowRankSource)
+							fogTable.lowRank = lutRefitter.getLowRank();
+						else
+							fogTable.fit = lutRefitter.getFit(refitTarget);
+						if (!standInReady)
+							fogParams.source = hooblerFog ? FroxelFog::Source::HOOBLER_LUT : FroxelFog::Source::KOVALOVS_LUT;
+					}
+
+					if (fogSource == FroxelFog::Source::KOVALOVS_LUT_ARRAY)
+						lutArrayUnsaved |= updateKovalovsLutArray(kovalovsLutShader, kovalovsLutArray);
+					fogTable.lutArray = &kovalovsLutArray;
+
+					if ((int)randomLights.size() != g_lightCount)
+						randomLights = LightList::generateRandom(g_lightCount, glm::vec3(-10.0f, 0.0f, 0.0f), glm::vec3(10.0f, 5.0f, 30.0f), 1);
+
+					LightList::Light keyLight;
+					keyLight.position = g_lightPos;
+					keyLight.colour = g_lightColour;
+					keyLight.range = g_lightRange;
+					keyLight.g = g_gParam;
+					std::vector<LightList::Light>& lights = lightList.getLights();
+					lights.assign(1, keyLight);
+					lights.insert(lights.end(), randomLights.begin(), randomLights.end());
+					if (!g_perLightG)
+					{
+						for (LightList::Light& light : lights)
+							light.g = g_gParam;
+					}
+					lightList.upload();
+
+					fogTimer.begin();
+					froxelFog.inject(fogParams, lightList, noiseVolume, fogTable, frameRing);
+					froxelFog.integrate();
+					froxelFog.composite(raymarchTex, raymarchDepthTex, renderSize.x, renderSize.y);
+					fogTimer.end();
+				}
+				glPopDebugGroup();
+
+				// Compare the GPU image against the CPU reference traced with the same parameters:
+				if (g_renderCpuReference)
+				{
+					std::vector<glm::vec4> gpuPixels((size_t)WIDTH * HEIGHT), cpuPixels;
+					glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+					GLState::bindTexture(GL_TEXTURE_2D, raymarchTex);
+					glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, gpuPixels.data());
+
+					float start = glfwGetTime();
+					cpuRaymarcher.render(getRaymarchParams(sdfScene, currentFrame), WIDTH, HEIGHT, g_cpuPacketWidth, cpuPixels);
+					g_cpuRenderMs = (glfwGetTime() - start) * 1000.0f;
+
+					CpuRaymarcher::compare(gpuPixels, cpuPixels, g_cpuRmse, g_cpuMaxError);
+					printf("CPU raymarch (%i-wide packets, %u threads): %.2f ms, RMSE vs GPU %.6f, max error %.6f\n",
+						g_cpuPacketWidth, threadPool.getThreadCount(), g_cpuRenderMs, g_cpuRmse, g_cpuMaxError);
+
+					CpuRaymarcher::writePPM("raymarch_cpu.ppm", cpuPixels, WIDTH, HEIGHT);
+					CpuRaymarcher::writePPM("raymarch_gpu.ppm", gpuPixels, WIDTH, HEIGHT);
+					g_renderCpuReference = false;
+				}
+
+				// Noise volume stuffs:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, noiseDebugText.size(), noiseDebugText.c_str());
+				if (g_animateNoise)
+				{
+					if (g_noiseRingMode)
+						noiseVolume.generateIncremental(g_noiseFreq, g_noiseScrollSpeed, currentFrame);
+					else
+						noiseVolume.generateFull(g_noiseFreq, currentFrame);
+				}
+				glPopDebugGroup();
+
+				GLuint displayedLutTex = g_KorH ? g_accumOrSum ? hooblerAccumLutTex : hooblerSummedLutTex : kovalovsLutTex;
+				if (g_KorH && g_spectralLut)
+					displayedLutTex = spectralDisplayTex;
+				if (g_displayRaymarch)
+					displayedLutTex = raymarchTex;
+
+				// Rebuild mip chains of everything written this frame:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, mipDebugText.size(), mipDebugText.c_str());
+				if (g_generateMips)
+				{
+					MipGenerator::Filter filter = (MipGenerator::Filter)g_mipFilter;
+					mipGenerator.generate2D(hooblerAccumLutTex, GL_RGBA32F, renderSize.x, renderSize.y, filter);
+					mipGenerator.generate2D(hooblerSummedLutTex, GL_RGBA32F, renderSize.x, renderSize.y, filter);
+					mipGenerator.generate2D(kovalovsLutTex, GL_R32F, renderSize.x, renderSize.y, filter);
+
+					if (g_animateNoise && noiseVolume.getSlicesGenerated() > 0)
+						mipGenerator.generate3D(noiseVolume.getTexture(), GL_RGBA32F, NOISE_WIDTH, NOISE_HEIGHT, NOISE_DEPTH, filter);
+				}
+				glPopDebugGroup();
+
+				// Statistics for the next frames' display normalisation and Hoobler's encoding scale:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, statsDebugText.size(), statsDebugText.c_str());
+				{
+					hooblerStats.compute(hooblerAccumLutTex, renderSize.x, renderSize.y);
+					if (!g_displayNoise)
+						displayStats.compute(displayedLutTex, renderSize.x, renderSize.y);
+				}
+				glPopDebugGroup();
+
+				// Block until compute operations have been completed (the blit reads through a framebuffer):
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+
+				// Take outputted textures and display on-screen:
+				glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, fullscreenDebugText.size(), fullscreenDebugText.c_str());
+				const bool autoNormalise = g_autoNormalise && !g_displayNoise && !g_displayRaymarch;
+				if (g_blitPresent && !g_displayNoise && !autoNormalise && g_displayLod == 0.0f)
+					fullscreenPass.present(displayedLutTex, renderSize.x, renderSize.y, WIDTH, HEIGHT);
+				else
+				{
+					fullscreenShader.use();
+					fullscreenShader.setInt("u_displayMode", g_displayNoise ? 1 : 0);
+					fullscreenShader.setFloat("u_displayLod", g_displayLod);
+					fullscreenShader.setVec2("u_uvScale", glm::vec2(renderSize) / glm::vec2(WIDTH, HEIGHT));
+					fullscreenShader.setFloat("u_noiseSliceZ", g_noiseSliceZ);
+					fullscreenShader.setFloat("u_noiseRingOffset", noiseVolume.getRingOffset());
+					fullscreenShader.setFloat("u_noiseDepth", (float)noiseVolume.getDepth());
+					GLState::activeTexture(GL_TEXTURE1);
+					GLState::bindTexture(GL_TEXTURE_3D, noiseVolume.getTexture());
+					fullscreenShader.setBool("u_autoNormalise", autoNormalise);
+					fullscreenShader.setInt("u_statsChannels", displayedLutTex == kovalovsLutTex ? 1 : 3);
+					GLState::bindBufferBase(GL_SHADER_STORAGE_BUFFER, TextureStats::STATS_BINDING, displayStats.getStatsBuffer());
+					GLState::activeTexture(GL_TEXTURE0);
+					GLState::bindTexture(GL_TEXTURE_2D, displayedLutTex);
+					fullscreenPass.draw();
+				}
+				glPopDebugGroup();
 			}
 			glPopDebugGroup();
 
-			// Block until compute operations have been completed:
-			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-			// Take outputted textures and display on-screen:
-			glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, fullscreenDebugText.size(), fullscreenDebugText.c_str());
+			glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, guiDebugText.size(), guiDebugText.c_str());
 			{
-				fullscreenShader.use();
-				glActiveTexture(GL_TEXTURE0);
-				g_KorH ? g_accumOrSum ? glBindTexture(GL_TEXTURE_2D, hooblerAccumLutTex)
-									  : glBindTexture(GL_TEXTURE_2D, hooblerSummedLutTex)
-					   : glBindTexture(GL_TEXTURE_2D, kovalovsLutTex);
-				fullscreenVAO.bind();
-				glDrawArrays(GL_TRIANGLES, 0, 6);
+				gui(noiseVolume, raymarchTimer, sdfScene, sdfVolume, bakeTimer, hooblerTimer, kovalovsTimer, spectralTimer, fogTimer, dynamicResolution, frameRing, textureLoader);
 			}
 			glPopDebugGroup();
-		}
-		glPopDebugGroup();
 
-		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, guiDebugText.size(), guiDebugText.c_str());
-		{
-			gui();
+			frameRing.endFrame();
+			glfwSwapBuffers(window);
+			glfwPollEvents();
 		}
-		glPopDebugGroup();
 
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+		if (lutArrayUnsaved)
+			kovalovsLutArray.save(LUT_ARRAY_CACHE_PATH);
 	}
 
 	// Shutdown ImGui:
@@ -288,6 +913,8 @@ GLFWwindow* initOpenGL()
 		std::cout << "Failed to initialise GLAD." << std::endl;
 		return nullptr;
 	}
+	if (g_useDsa && !GLDsa::load((GLADloadproc)glfwGetProcAddress))
+		std::cout << "Direct state access unavailable, setting objects up through binds." << std::endl;
 	glViewport(0, 0, WIDTH, HEIGHT);
 	return newWindow;
 }
@@ -308,9 +935,25 @@ void processInput(GLFWwindow* window, float dt)
 
 	const float speed = 3.0f * dt;
 
+	// Move the raymarching camera:
+	if (glfwGetKey(window, GLFW_KEY_W))
+		g_cameraPos.z += speed;
+	if (glfwGetKey(window, GLFW_KEY_S))
+		g_cameraPos.z -= speed;
+	if (glfwGetKey(window, GLFW_KEY_A))
+		g_cameraPos.x -= speed;
+	if (glfwGetKey(window, GLFW_KEY_D))
+		g_cameraPos.x += speed;
+	if (glfwGetKey(window, GLFW_KEY_E))
+		g_cameraPos.y += speed;
+	if (glfwGetKey(window, GLFW_KEY_Q))
+		g_cameraPos.y -= speed;
+
 }
 
-void gui()
+void gui(const NoiseVolume& noiseVolume, const GpuTimer& raymarchTimer, SdfScene& sdfScene, const SdfVolume& sdfVolume, const GpuTimer& bakeTimer,
+	const GpuTimer& hooblerTimer, const GpuTimer& kovalovsTimer, const GpuTimer& spectralTimer, const GpuTimer& fogTimer,
+	const DynamicResolution& dynamicResolution, const RingBuffer& frameRing, TextureLoader& textureLoader)
 {
 	ImGui::Begin("ImGui");
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
@@ -329,14 +972,831 @@ void gui()
 	ImGui::Text("Hoobler data:");
 	ImGui::SliderFloat("vecLength", &g_vecLength, 0.0f, 50.0f);
 	ImGui::SliderFloat("lightZFar", &g_lightZFar, 0.0f, 50.0f);
-	ImGui::DragFloat3("Wavelength divisors", &g_wavelengthDivisor.x, 1.0f, 1.0f, 400.0f);
+	ImGui::Checkbox("Spectral LUT", &g_spectralLut);
+	if (g_spectralLut)
+	{
+		ImGui::SliderInt("Bands", &g_spectralBands, 1, SpectralLut::MAX_BANDS);
+		ImGui::SliderInt("Displayed layer", &g_spectralDisplayLayer, 0, (g_spectralBands - 1) / SpectralLut::BANDS_PER_LAYER);
+		ImGui::SliderFloat("Spectral divisor", &g_spectralDivisor, 1.0f, 1000.0f);
+		ImGui::Text("Spectral pass: %.3f ms for %i bands", spectralTimer.getMilliseconds(), g_spectralBands);
+	}
+
+	ImGui::Text("LUT axes (refit after changing):");
+	warpGui("Hoobler distance", g_hooblerWarps[0]);
+	warpGui("Hoobler angle", g_hooblerWarps[1]);
+	warpGui("Kovalovs radius", g_kovalovsWarps[0]);
+	warpGui("Kovalovs angle", g_kovalovsWarps[1]);
 
 	ImGui::Text("Light data:");
 	ImGui::SliderFloat("Light constant", &g_constant, 0.0f, 1.0f);
 	ImGui::SliderFloat("Light linear", &g_linear, 0.0f, 0.5f);
 	ImGui::SliderFloat("Light quadratic", &g_quadratic, 0.0f, 0.1f);
 
+	ImGui::Text("Noise data:");
+	ImGui::Checkbox("Display noise volume", &g_displayNoise);
+	ImGui::Checkbox("Animate noise", &g_animateNoise);
+	ImGui::Checkbox("Scroll ring of z-slices", &g_noiseRingMode);
+	ImGui::SliderFloat("Noise frequency", &g_noiseFreq, 0.005f, 0.2f);
+	ImGui::SliderFloat("Noise scroll speed", &g_noiseScrollSpeed, 0.0f, 5.0f);
+	ImGui::SliderFloat("Noise slice", &g_noiseSliceZ, 0.0f, 1.0f);
+	ImGui::Text("Slices generated this frame: %i / %i", noiseVolume.getSlicesGenerated(), noiseVolume.getDepth());
+
+	ImGui::Text("Mip data:");
+	ImGui::Checkbox("Generate mips", &g_generateMips);
+	ImGui::Combo("Mip filter", &g_mipFilter, "Box\0Max\0Min\0");
+	ImGui::SliderFloat("Display LOD", &g_displayLod, 0.0f, 10.0f);
+	ImGui::Checkbox("Blit to screen when unshaded", &g_blitPresent);
+
+	ImGui::Text("Dynamic resolution:");
+	ImGui::Checkbox("Scale to GPU budget", &g_dynamicResolution);
+	ImGui::SliderFloat("Compute budget (ms)", &g_computeBudgetMs, 0.5f, 33.0f);
+	ImGui::SliderFloat("Min resolution scale", &g_minResolutionScale, 0.125f, 1.0f);
+	glm::ivec2 renderSize = dynamicResolution.getSize();
+	ImGui::Text("Rendering %ix%i (%.0f%%)", renderSize.x, renderSize.y, dynamicResolution.getScale() * 100.0f);
+	ImGui::Text("LUT passes: Hoobler %.3f ms, Kovalovs %.3f ms", hooblerTimer.getMilliseconds(), kovalovsTimer.getMilliseconds());
+
+	ImGui::Text("Volumetric fog:");
+	ImGui::Checkbox("Fog raymarched scene", &g_fog);
+	ImGui::Combo("In-scattering from", &g_fogSource, "Analytic\0Kovalovs LUT\0Hoobler LUT\0Kovalovs fit\0Hoobler fit\0Hoobler low rank\0Kovalovs LUT array\0");
+	ImGui::SliderFloat("Fog density", &g_fogDensity, 0.0f, 0.5f);
+	ImGui::ColorEdit3("Fog albedo", &g_fogAlbedo.x);
+	ImGui::SliderFloat("Height falloff", &g_fogHeightFalloff, 0.0f, 2.0f);
+	ImGui::SliderFloat("Noise amount", &g_fogNoiseAmount, 0.0f, 1.0f);
+	ImGui::DragFloat3("Light position", &g_lightPos.x, 0.05f);
+	ImGui::DragFloat3("Light colour", &g_lightColour.x, 0.1f, 0.0f, 1000.0f);
+	ImGui::SliderFloat("Light range", &g_lightRange, 1.0f, 50.0f);
+	ImGui::SliderInt("Extra lights", &g_lightCount, 0, LightList::MAX_LIGHTS - 1);
+	ImGui::Checkbox("Per-light g", &g_perLightG);
+	ImGui::SliderInt("Fit bands", &g_fitBands, 1, 64);
+	ImGui::SliderInt("Fit degree (distance)", &g_fitDegreeU, 0, LutFit::MAX_DEGREE);
+	ImGui::SliderInt("Fit degree (angle)", &g_fitDegreeV, 0, LutFit::MAX_DEGREE);
+	ImGui::SliderInt("Low rank", &g_lowRank, 1, LowRankLut::MAX_RANK);
+	ImGui::SliderFloat("Refit interval (s)", &g_refitInterval, 0.0f, 5.0f);
+	if (ImGui::Button("Refit LUT"))
+		g_refitLut = true;
+	ImGui::SameLine();
+	ImGui::Text("Last fit: RMSE %g, max error %g", g_fitRmse, g_fitMaxError);
+	ImGui::SliderInt("LUT array layers", &g_lutArrayLayers, 2, 64);
+	ImGui::SliderInt("LUT array size", &g_lutArraySize, 32, 1024);
+	ImGui::Checkbox("Animate g", &g_animateG);
+	ImGui::SameLine();
+	ImGui::Text("(%.1f MB array)", (float)g_lutArrayLayers * g_lutArraySize * g_lutArraySize * sizeof(float) / (1024.0f * 1024.0f));
+	ImGui::Text("Fog %ix%ix%i froxels in clusters of %ix%ix%i: %.3f ms", FROXEL_WIDTH, FROXEL_HEIGHT, FROXEL_DEPTH,
+		FroxelFog::CLUSTER_WIDTH, FroxelFog::CLUSTER_HEIGHT, FroxelFog::CLUSTER_DEPTH, fogTimer.getMilliseconds());
+
+	ImGui::Text("Raymarch data:");
+	ImGui::Checkbox("Display raymarched scene", &g_displayRaymarch);
+	if (ImGui::Button("Reload scene") && sdfScene.loadFromFile(g_scenePath.c_str()))
+		sdfScene.upload();
+	ImGui::SameLine();
+	ImGui::Text("%s (%i primitives)", g_scenePath.c_str(), sdfScene.getPrimitiveCount());
+
+	// Per-primitive editor, re-uploading the scene when anything changes:
+	bool sceneChanged = false;
+	std::vector<SdfScene::Object>& objects = sdfScene.getObjects();
+	for (size_t i = 0; i < objects.size(); ++i)
+	{
+		SdfScene::Object& object = objects[i];
+		if (!ImGui::TreeNode((void*)(intptr_t)i, "Primitive %i", (int)i))
+			continue;
+
+		int type = (int)object.type, op = (int)object.op;
+		if (ImGui::Combo("Type", &type, "Sphere\0Box\0Torus\0Plane\0Capsule\0"))
+			object.type = (SdfScene::Type)type, sceneChanged = true;
+		if (ImGui::Combo("Op", &op, "Union\0Subtract\0Intersect\0"))
+			object.op = (SdfScene::Op)op, sceneChanged = true;
+		sceneChanged |= ImGui::SliderFloat("Blend size", &object.blendK, 0.0f, 2.0f);
+		sceneChanged |= ImGui::DragFloat3("Position", &object.position.x, 0.05f);
+		sceneChanged |= ImGui::DragFloat3("Rotation", &object.rotation.x, 1.0f);
+		sceneChanged |= ImGui::DragFloat("Scale", &object.scale, 0.01f, 0.01f, 10.0f);
+		sceneChanged |= ImGui::DragFloat4("Params", &object.params.x, 0.01f);
+		ImGui::TreePop();
+	}
+	if (sceneChanged)
+		sdfScene.upload();
+
+	ImGui::Checkbox("Tile culling", &g_tileCulling);
+	ImGui::Checkbox("March baked SDF", &g_useBakedSdf);
+	ImGui::Checkbox("Checkerboard + reprojection", &g_checkerboard);
+	if (g_checkerboard)
+		ImGui::SliderFloat("History depth tolerance", &g_depthTolerance, 0.001f, 0.2f);
+	g_rebakeSdf |= ImGui::SliderInt("SDF resolution", &g_sdfResolution, 32, 256);
+	g_rebakeSdf |= ImGui::SliderFloat("SDF band", &g_sdfBand, 0.05f, 4.0f);
+	g_rebakeSdf |= ImGui::Checkbox("Cull primitives per slab", &g_sdfCullSlabs);
+	ImGui::Checkbox("Rebake every frame", &g_rebakeSdfEveryFrame);
+	glm::ivec3 sdfSize = sdfVolume.getSize();
+	ImGui::Text("Baked %ix%ix%i, voxel %.3f, bake %.2f ms", sdfSize.x, sdfSize.y, sdfSize.z, sdfVolume.getVoxelSize(), bakeTimer.getMilliseconds());
+	ImGui::SliderInt("Max steps", &g_maxSteps, 1, 500);
+	ImGui::SliderFloat("Over-relaxation", &g_relaxation, 1.0f, 1.99f);
+	ImGui::SliderFloat("Hit epsilon", &g_epsilon, 0.0001f, 0.1f, "%.4f");
+	ImGui::Checkbox("Relative epsilon", &g_relativeEpsilon);
+	ImGui::Checkbox("Bounding-sphere early-outs", &g_useBounds);
+	ImGui::Combo("Raymarch view", &g_raymarchView, "Shaded\0Steps per pixel\0Primitives per tile\0");
+	ImGui::Text("GPU: %.3f ms (avg %.3f ms), %.2f steps per pixel",
+		raymarchTimer.getMilliseconds(), raymarchTimer.getAverageMilliseconds(), g_stepsPerPixel);
+	ImGui::RadioButton("8-wide packets", &g_cpuPacketWidth, 8);
+	ImGui::SameLine();
+	ImGui::RadioButton("16-wide packets", &g_cpuPacketWidth, 16);
+	if (ImGui::Button("Render CPU reference"))
+		g_renderCpuReference = true;
+	ImGui::Text("CPU: %.2f ms, RMSE %.6f, max error %.6f", g_cpuRenderMs, g_cpuRmse, g_cpuMaxError);
+
+	ImGui::Text("GL state (objects set up %s):", GLDsa::isAvailable() ? "with DSA" : "through binds");
+	ImGui::Checkbox("Elide redundant binds", &g_elideGlState);
+	ImGui::Text("Last frame: %u binds issued, %u elided", g_glStateCounters.getIssued(), g_glStateCounters.getElided());
+	for (int i = 0; i < (int)GLState::Call::COUNT; ++i)
+		ImGui::Text("  %-20s %5u issued %5u elided", GLState::getCallName((GLState::Call)i), g_glStateCounters.issued[i], g_glStateCounters.elided[i]);
+	if (frameRing.isAvailable())
+		ImGui::Text("Frame ring: %lld / %lld bytes (peak %lld), %u overflows, %u stalls", (long long)frameRing.getUsed(),
+			(long long)frameRing.getFrameSize(), (long long)frameRing.getPeakUsed(), frameRing.getOverflowCount(), frameRing.getStallCount());
+	else
+		ImGui::Text("Frame ring: unavailable, using buffer updates");
+
+	ImGui::Text("Textures (%i loading, %lld bytes uploaded last frame):", textureLoader.getPendingCount(), (long long)textureLoader.getBytesUploaded());
+	ImGui::InputText("Path", g_textureLoadPath, sizeof(g_textureLoadPath));
+	ImGui::SameLine();
+	if (ImGui::Button("Load") && g_textureLoadPath[0])
+		textureLoader.load(g_textureLoadPath);
+	for (int i = 0; i < textureLoader.getCount(); ++i)
+	{
+		const char* states[] = { "decoding", "uploading", "ready", "failed" };
+		ImGui::Text("%s: %ix%i, %s", textureLoader.getPath(i).c_str(), textureLoader.getWidth(i), textureLoader.getHeight(i),
+			states[(int)textureLoader.getState(i)]);
+		if (textureLoader.getTexture(i))
+			ImGui::Image((ImTextureID)(intptr_t)textureLoader.getTexture(i), ImVec2(64, 64), ImVec2(0, 1), ImVec2(1, 0));
+		else
+			ImGui::ProgressBar(textureLoader.getProgress(i));
+	}
+
+	ImGui::Text("Statistics:");
+	ImGui::Checkbox("Auto-normalise display", &g_autoNormalise);
+	ImGui::Checkbox("Auto Hoobler LUT scale", &g_autoLutScale);
+	if (!g_autoLutScale)
+		ImGui::DragFloat("Hoobler LUT scale", &g_hooblerLutScale, 0.0001f, 0.000001f, 1.0f, "%.6f");
+	ImGui::Text("Min:  (%.4g, %.4g, %.4g, %.4g)", g_displayStats.minVal.r, g_displayStats.minVal.g, g_displayStats.minVal.b, g_displayStats.minVal.a);
+	ImGui::Text("Max:  (%.4g, %.4g, %.4g, %.4g)", g_displayStats.maxVal.r, g_displayStats.maxVal.g, g_displayStats.maxVal.b, g_displayStats.maxVal.a);
+	ImGui::Text("Mean: (%.4g, %.4g, %.4g, %.4g)", g_displayStats.mean.r, g_displayStats.mean.g, g_displayStats.mean.b, g_displayStats.mean.a);
+	ImGui::PlotHistogram("Histogram (R)", g_displayHistogram, TextureStats::HISTOGRAM_BINS, 0, NULL, 0.0f, FLT_MAX, ImVec2(0, 80));
+
 	ImGui::End();
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-}
\ No newline at end of file
+}
+
+void warpGui(const char* label, AxisWarp& warp)
+{
+	ImGui::PushID(label);
+	int type = (int)warp.type;
+	if (ImGui::Combo(label, &type, "Linear\0Power\0Log\0Phase CDF\0"))
+	{
+		// Params mean something different per type, so start each from a sensible value:
+		const float defaultParams[] = { 1.0f, 2.0f, 4.0f, g_gParam * 0.5f };
+		warp.type = (AxisWarp::Type)type;
+		warp.param = defaultParams[type];
+	}
+
+	switch (warp.type)
+	{
+		case AxisWarp::Type::POWER:
+			ImGui::SliderFloat("Exponent", &warp.param, 1.0f, 8.0f);
+			break;
+		case AxisWarp::Type::LOG:
+			ImGui::SliderFloat("Steepness", &warp.param, 0.1f, 16.0f);
+			break;
+		case AxisWarp::Type::PHASE_CDF:
+			ImGui::SliderFloat("Phase g", &warp.param, -0.95f, 0.95f);
+			break;
+		default:
+			break;
+	}
+	ImGui::PopID();
+}
+
+RaymarchParams getRaymarchParams(const SdfScene& sdfScene, float time)
+{
+	RaymarchParams params;
+	params.primitives	= sdfScene.getPrimitives();
+	params.cameraPos	= g_cameraPos;
+	params.time			= time;
+
+	params.maxSteps			= g_maxSteps;
+	params.relaxation		= g_relaxation;
+	params.epsilon			= g_epsilon;
+	params.relativeEpsilon	= g_relativeEpsilon;
+	params.useBounds		= g_useBounds;
+	return params;
+}
+
+SpectralLut::Params getSpectralLutParams(int bands)
+{
+	SpectralLut::Params params;
+	const float longest = glm::max(g_wavelengths.x, glm::max(g_wavelengths.y, g_wavelengths.z));
+	const float shortest = glm::min(g_wavelengths.x, glm::min(g_wavelengths.y, g_wavelengths.z));
+	for (int i = 0; i < bands; ++i)
+	{
+		const float wavelength = SpectralLut::getBandWavelength(i, bands, longest, shortest);
+		params.coefficients.push_back(g_scatterStrength * powf(g_spectralDivisor / wavelength, 4));
+	}
+
+	params.vecLength		= g_vecLength;
+	params.lightZFar		= g_lightZFar;
+	params.gParam			= g_gParam;
+	params.constant			= g_constant;
+	params.linear			= g_linear;
+	params.quadratic		= g_quadratic;
+	params.lutScale			= g_hooblerLutScale;
+	params.distanceWarp		= g_hooblerWarps[0];
+	params.angleWarp		= g_hooblerWarps[1];
+	return params;
+}
+
+FroxelFog::Params getFogParams(glm::ivec2 renderSize)
+{
+	FroxelFog::Params params;
+	params.source		= (FroxelFog::Source)g_fogSource;
+	params.cameraPos	= g_cameraPos;
+	params.aspect		= (float)renderSize.x / renderSize.y;
+
+	params.density			= g_fogDensity;
+	params.albedo			= g_fogAlbedo;
+	params.baseHeight		= 0.0f;
+	params.heightFalloff	= g_fogHeightFalloff;
+	params.noiseAmount		= g_fogNoiseAmount;
+	params.gParam			= g_gParam;
+
+	params.constant			= g_constant;
+	params.linear			= g_linear;
+	params.quadratic		= g_quadratic;
+	params.hooblerZFar		= g_lightZFar;
+	params.kovalovsRange	= g_lightRange;
+
+	const bool hoobler = params.source == FroxelFog::Source::HOOBLER_LUT || params.source == FroxelFog::Source::HOOBLER_FIT
+		|| params.source == FroxelFog::Source::HOOBLER_LOW_RANK;
+	params.distanceWarp		= hoobler ? g_hooblerWarps[0] : g_kovalovsWarps[0];
+	params.angleWarp		= hoobler ? g_hooblerWarps[1] : g_kovalovsWarps[1];
+	return params;
+}
+
+void bakeHooblerLut(const Shader& accumShader, const Shader& sumShader, GLuint scatterAccumTex, GLuint accumLutTex, GLuint summedLutTex, glm::ivec2 size)
+{
+	accumShader.use();
+	accumShader.setFloat("u_tau", g_tau);
+	accumShader.setFloat("u_distance", g_distance);
+	accumShader.setFloat("u_gParam", g_gParam);
+
+	accumShader.setFloat("u_vecLength", g_vecLength);
+	accumShader.setFloat("u_lightZFar", g_lightZFar);
+
+	accumShader.setFloat("u_constant", g_constant);
+	accumShader.setFloat("u_linear", g_linear);
+	accumShader.setFloat("u_quadratic", g_quadratic);
+	accumShader.setFloat("u_lutScale", g_hooblerLutScale);
+	accumShader.setIVec2("u_lutSize", size);
+	g_hooblerWarps[0].setUniforms(accumShader, "u_distance");
+	g_hooblerWarps[1].setUniforms(accumShader, "u_angle");
+
+	GLState::bindImageTexture(3, scatterAccumTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+	GLState::bindImageTexture(4, accumLutTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+	GLState::bindImageTexture(5, summedLutTex, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+	glDispatchCompute(size.x / 32, size.y / 8, 1);
+
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+	// Each group sums whole rows:
+	sumShader.use();
+	sumShader.setIVec2("u_lutSize", size);
+	glDispatchCompute(1, size.y / 4, 1);
+}
+
+void bakeKovalovsLut(const Shader& shader, GLuint lutTex, glm::ivec2 size, float gParam, int layer)
+{
+	shader.use();
+	shader.setFloat("u_gParam", gParam);
+	shader.setFloat("u_range", g_lightRange);
+
+	shader.setFloat("u_constant", g_constant);
+	shader.setFloat("u_linear", g_linear);
+	shader.setFloat("u_quadratic", g_quadratic);
+	shader.setIVec2("u_lutSize", size);
+	g_kovalovsWarps[0].setUniforms(shader, "u_distance");
+	g_kovalovsWarps[1].setUniforms(shader, "u_angle");
+
+	// Layer is ignored for a plain 2D texture, and picks one slice of an array:
+	GLState::bindImageTexture(6, lutTex, 0, GL_FALSE, layer, GL_WRITE_ONLY, GL_R32F);
+	glDispatchCompute(1, size.y, 1);
+}
+
+LutArray::Layout getKovalovsLutArrayLayout()
+{
+	// Everything bakeKovalovsLut() reads besides g:
+	const float bakeParams[] = {
+		g_lightRange, g_constant, g_linear, g_quadratic,
+		(float)g_kovalovsWarps[0].type, g_kovalovsWarps[0].param, (float)g_kovalovsWarps[1].type, g_kovalovsWarps[1].param
+	};
+
+	LutArray::Layout layout;
+	layout.format	= GL_R32F;
+	layout.width	= g_lutArraySize;
+	layout.height	= g_lutArraySize;
+	layout.layers	= g_lutArrayLayers;
+	layout.gMin		= g_lutArrayGMin;
+	layout.gMax		= g_lutArrayGMax;
+	layout.key		= LutArray::hash(bakeParams, sizeof(bakeParams));
+	return layout;
+}
+
+// Hash of everything bakeHooblerLut() or bakeKovalovsLut() reads, and the region of the LUT in use, so
+// what's taken from a LUT can tell when it's stale. Hoobler's encoding scale is left out, since
+// readLutTable() undoes it:
+uint64_t getLutBakeKey(bool hoobler, glm::ivec2 region)
+{
+	if (hoobler)
+	{
+		const float bakeParams[] = {
+			g_tau, g_distance, g_gParam, g_vecLength, g_lightZFar, g_constant, g_linear, g_quadratic,
+			(float)g_hooblerWarps[0].type, g_hooblerWarps[0].param, (float)g_hooblerWarps[1].type, g_hooblerWarps[1].param,
+			(float)region.x, (float)region.y
+		};
+		return LutArray::hash(bakeParams, sizeof(bakeParams));
+	}
+
+	const float bakeParams[] = {
+		g_gParam, g_lightRange, g_constant, g_linear, g_quadratic,
+		(float)g_kovalovsWarps[0].type, g_kovalovsWarps[0].param, (float)g_kovalovsWarps[1].type, g_kovalovsWarps[1].param,
+		(float)region.x, (float)region.y
+	};
+	return LutArray::hash(bakeParams, sizeof(bakeParams));
+}
+
+// Rebake every slice if anything the array depends on changed, returning whether it did:
+bool updateKovalovsLutArray(const Shader& shader, LutArray& lutArray)
+{
+	const LutArray::Layout layout = getKovalovsLutArrayLayout();
+	if (lutArray.getLayout() == layout)
+		return false;
+
+	lutArray.allocate(layout);
+	for (int layer = 0; layer < layout.layers; ++layer)
+		bakeKovalovsLut(shader, lutArray.getTexture(), glm::ivec2(layout.width, layout.height), lutArray.getG(layer), layer);
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	return true;
+}
+
+void setRaymarchUniforms(const Shader& shader, const RaymarchParams& params)
+{
+	shader.setVec3("u_cameraPos", params.cameraPos);
+	shader.setFloat("u_time", params.time);
+
+	shader.setInt("u_maxSteps", params.maxSteps);
+	shader.setFloat("u_relaxation", params.relaxation);
+	shader.setFloat("u_epsilon", params.epsilon);
+	shader.setInt("u_epsilonMode", params.relativeEpsilon ? 1 : 0);
+	shader.setBool("u_useBounds", params.useBounds);
+	shader.setInt("u_debugView", g_raymarchView);
+}
+
+int runCpuRaymarch(int argc, char** argv)
+{
+	// Usage: --cpu-raymarch <output.ppm> [width] [height] [packet width (8 or 16)] [time] [--scene <file.sdf>]
+	const char* path	= argc > 2 ? argv[2] : "raymarch_cpu.ppm";
+	int width			= argc > 3 ? std::stoi(argv[3]) : WIDTH;
+	int height			= argc > 4 ? std::stoi(argv[4]) : HEIGHT;
+	int packetWidth		= argc > 5 ? std::stoi(argv[5]) : 8;
+	float time			= argc > 6 ? std::stof(argv[6]) : 0.0f;
+
+	SdfScene sdfScene;
+	if (!sdfScene.loadFromFile(g_scenePath.c_str()))
+		return -1;
+	sdfScene.buildPrimitives();
+
+	ThreadPool threadPool;
+	CpuRaymarcher cpuRaymarcher(threadPool);
+	std::vector<glm::vec4> pixels;
+
+	auto start = std::chrono::steady_clock::now();
+	cpuRaymarcher.render(getRaymarchParams(sdfScene, time), width, height, packetWidth, pixels);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	printf("CPU raymarch %ix%i (%i-wide packets, %u threads): %.2f ms\n",
+		width, height, packetWidth, threadPool.getThreadCount(), elapsed.count());
+
+	if (!CpuRaymarcher::writePPM(path, pixels, width, height))
+	{
+		std::cout << "Failed to write " << path << std::endl;
+		return -1;
+	}
+	return 0;
+}
+
+std::vector<LutWarpConfig> getLutWarpConfigs()
+{
+	const AxisWarp linearWarp = {};
+	const AxisWarp powerWarp = { AxisWarp::Type::POWER, 2.0f };
+	const AxisWarp logWarp = { AxisWarp::Type::LOG, 4.0f };
+	const AxisWarp cdfWarp = { AxisWarp::Type::PHASE_CDF, g_gParam * 0.5f };
+	return {
+		{ "Linear",			linearWarp,	linearWarp },
+		{ "Power 2",		powerWarp,	linearWarp },
+		{ "Log 4",			logWarp,	linearWarp },
+		{ "Phase CDF",		linearWarp,	cdfWarp },
+		{ "Power 2 + CDF",	powerWarp,	cdfWarp },
+		{ "Log 4 + CDF",	logWarp,	cdfWarp },
+	};
+}
+
+int runLutBenchmark(int argc, char** argv)
+{
+	// Usage: --lut-benchmark [table width] [table height] [samples per texel]
+	int width			= argc > 2 ? std::stoi(argv[2]) : 512;
+	int height			= argc > 3 ? std::stoi(argv[3]) : 256;
+	int samplesPerTexel	= argc > 4 ? std::stoi(argv[4]) : 64;
+
+	const int lutSizes[] = { 64, 128, 256, 512, 1024 };
+	const int BAKE_REPEATS = 20;
+	const int KOVALOVS_STEPS_PER_TEXEL = 16;
+	const std::vector<LutWarpConfig> warpConfigs = getLutWarpConfigs();
+
+	GLFWwindow* window = initOpenGL();
+	if (!window)
+		return -1;
+
+	// Scoped so the GL objects are deleted before the context is destroyed:
+	{
+		Shader hooblerAccumLutShader;
+		Shader hooblerSumLutShader;
+		Shader kovalovsLutShader;
+		hooblerAccumLutShader.loadShader("res/hooblerAccumLUTShader.comp");
+		hooblerSumLutShader.loadShader("res/hooblerSumLUTShader.comp");
+		kovalovsLutShader.loadShader("res/kovalovsLUTShader.comp");
+
+		ScatteringModel model;
+		model.gParam	= g_gParam;
+		model.constant	= g_constant;
+		model.linear	= g_linear;
+		model.quadratic	= g_quadratic;
+
+		ThreadPool threadPool;
+		ScatteringReference reference(threadPool);
+		std::vector<float> truth;
+
+		auto start = std::chrono::steady_clock::now();
+		reference.bake(model, g_vecLength, g_lightZFar, width, height, samplesPerTexel, truth);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		const float peak = *std::max_element(truth.begin(), truth.end());
+		printf("Ground truth %ix%i, %i samples per texel (%u threads): %.2f ms, peak %g\n",
+			width, height, samplesPerTexel, threadPool.getThreadCount(), elapsed.count(), peak);
+
+		// Kovalovs' LUT is stretched over the furthest any point of the table's rays gets from the light, and
+		// Hoobler's is stored unscaled:
+		g_lightRange = 2.0f * g_vecLength + g_lightZFar;
+		g_hooblerLutScale = 1.0f;
+
+		GpuTimer bakeTimer;
+		bakeTimer.init();
+
+		auto createLut = [](GLenum format, int size)
+		{
+			return GLDsa::createTexture2D(format, size, size, 1, GL_NEAREST, GL_NEAREST);
+		};
+
+		printf("\n%-10s %-14s %10s %14s %14s %14s %14s\n", "Method", "Warp", "Resolution", "Bake GPU ms", "RMSE", "Max error", "Max error %");
+		for (const LutWarpConfig& warps : warpConfigs)
+		for (int size : lutSizes)
+		{
+			g_hooblerWarps[0] = g_kovalovsWarps[0] = warps.distance;
+			g_hooblerWarps[1] = g_kovalovsWarps[1] = warps.angle;
+
+			TextureHandle scatterAccumTex		= createLut(GL_RGBA32F, size);
+			TextureHandle hooblerAccumLutTex	= createLut(GL_RGBA32F, size);
+			TextureHandle hooblerSummedLutTex	= createLut(GL_RGBA32F, size);
+			TextureHandle kovalovsLutTex		= createLut(GL_R32F, size);
+
+			for (int method = 0; method < 2; ++method)
+			{
+				const bool hoobler = method == 0;
+
+				// Each bake is waited on, so its query is ready to collect straight away:
+				double bakeMs = 0.0;
+				for (int i = 0; i < BAKE_REPEATS; ++i)
+				{
+					bakeTimer.begin();
+					if (hoobler)
+						bakeHooblerLut(hooblerAccumLutShader, hooblerSumLutShader, scatterAccumTex, hooblerAccumLutTex, hooblerSummedLutTex, glm::ivec2(size));
+					else
+						bakeKovalovsLut(kovalovsLutShader, kovalovsLutTex, glm::ivec2(size), g_gParam);
+					bakeTimer.end();
+					glFinish();
+					bakeTimer.poll();
+					bakeMs += bakeTimer.getMilliseconds();
+				}
+
+				glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+				std::vector<float> table;
+				if (hoobler)
+				{
+					std::vector<glm::vec4> lut((size_t)size * size);
+					GLState::bindTexture(GL_TEXTURE_2D, hooblerSummedLutTex);
+					glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, lut.data());
+					reference.evaluateHooblerLut(lut, size, size, warps.distance, warps.angle, width, height, table);
+				}
+				else
+				{
+					std::vector<float> lut((size_t)size * size);
+					GLState::bindTexture(GL_TEXTURE_2D, kovalovsLutTex);
+					glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, lut.data());
+					reference.evaluateKovalovsLut(lut, size, size, warps.distance, warps.angle, g_lightRange, g_vecLength, g_lightZFar,
+						width, height, KOVALOVS_STEPS_PER_TEXEL, table);
+				}
+
+				float rmse, maxError;
+				ScatteringReference::compare(table, truth, rmse, maxError);
+				printf("%-10s %-14s %10i %14.4f %14g %14g %14.3f\n", hoobler ? "Hoobler" : "Kovalovs", warps.name, size, bakeMs / BAKE_REPEATS,
+					rmse, maxError, peak > 0.0f ? maxError / peak * 100.0f : 0.0f);
+			}
+		}
+
+		// Spectral LUT with unwarped axes, every band in one pass, scored band by band against ground truth
+		// with that band's scattering and extinction. 'Per channel' is the single-channel bake once per band:
+		const int SPECTRAL_SIZE = 512;
+		const int spectralBandCounts[] = { 3, 6, 12 };
+		g_hooblerWarps[0] = g_hooblerWarps[1] = AxisWarp();
+
+		TextureHandle scatterAccumTex		= createLut(GL_RGBA32F, SPECTRAL_SIZE);
+		TextureHandle hooblerAccumLutTex	= createLut(GL_RGBA32F, SPECTRAL_SIZE);
+		TextureHandle hooblerSummedLutTex	= createLut(GL_RGBA32F, SPECTRAL_SIZE);
+		double channelMs = 0.0;
+		for (int i = 0; i < BAKE_REPEATS; ++i)
+		{
+			bakeTimer.begin();
+			bakeHooblerLut(hooblerAccumLutShader, hooblerSumLutShader, scatterAccumTex, hooblerAccumLutTex, hooblerSummedLutTex, glm::ivec2(SPECTRAL_SIZE));
+			bakeTimer.end();
+			glFinish();
+			bakeTimer.poll();
+			channelMs += bakeTimer.getMilliseconds() / BAKE_REPEATS;
+		}
+
+		SpectralLut spectralLut;
+		spectralLut.init();
+
+		printf("\n%-10s %10s %14s %14s %14s %14s\n", "Bands", "Resolution", "Bake GPU ms", "Per channel ms", "Worst RMSE", "Worst max %");
+		for (int bands : spectralBandCounts)
+		{
+			const SpectralLut::Params params = getSpectralLutParams(bands);
+			double bakeMs = 0.0;
+			for (int i = 0; i < BAKE_REPEATS; ++i)
+			{
+				bakeTimer.begin();
+				spectralLut.bake(params, glm::ivec2(SPECTRAL_SIZE));
+				bakeTimer.end();
+				glFinish();
+				bakeTimer.poll();
+				bakeMs += bakeTimer.getMilliseconds() / BAKE_REPEATS;
+			}
+
+			float worstRmse = 0.0f, worstPercent = 0.0f;
+			std::vector<glm::vec4> layer;
+			for (int band = 0; band < bands; ++band)
+			{
+				if (band % SpectralLut::BANDS_PER_LAYER == 0)
+					spectralLut.readLayer(band / SpectralLut::BANDS_PER_LAYER, layer);
+
+				ScatteringModel bandModel = model;
+				bandModel.scattering = params.coefficients[band];
+				bandModel.extinction = params.coefficients[band];
+				std::vector<float> bandTruth, table;
+				reference.bake(bandModel, g_vecLength, g_lightZFar, width, height, samplesPerTexel, bandTruth);
+
+				const glm::ivec2 lutSize = spectralLut.getAllocatedSize();
+				reference.evaluateHooblerLut(layer, lutSize.x, lutSize.y, params.distanceWarp, params.angleWarp, width, height, table,
+					band % SpectralLut::BANDS_PER_LAYER);
+
+				float rmse, maxError;
+				ScatteringReference::compare(table, bandTruth, rmse, maxError);
+				const float bandPeak = *std::max_element(bandTruth.begin(), bandTruth.end());
+				worstRmse = std::max(worstRmse, rmse);
+				worstPercent = std::max(worstPercent, bandPeak > 0.0f ? maxError / bandPeak * 100.0f : 0.0f);
+			}
+			printf("%-10i %10i %14.4f %14.4f %14g %14.3f\n", bands, SPECTRAL_SIZE, bakeMs, channelMs * bands, worstRmse, worstPercent);
+		}
+	}
+
+	glfwTerminate();
+	return 0;
+}
+
+void readLutTable(GLuint lutTex, bool hoobler, glm::ivec2 size, glm::ivec2 region, std::vector<float>& table)
+{
+	std::vector<glm::vec4> texels((size_t)size.x * size.y);
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	GLState::bindTexture(GL_TEXTURE_2D, lutTex);
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, texels.data());
+
+	// Hoobler's summed LUT is stored divided by the scale in A:
+	table.resize((size_t)region.x * region.y);
+	for (int y = 0; y < region.y; ++y)
+	{
+		for (int x = 0; x < region.x; ++x)
+		{
+			const glm::vec4& s = texels[(size_t)y * size.x + x];
+			table[(size_t)y * region.x + x] = hoobler ? s.r * s.a : s.r;
+		}
+	}
+}
+
+int runLutFit(int argc, char** argv)
+{
+	// Usage: --lut-fit [LUT size] [max rank]
+	int size	= argc > 2 ? std::stoi(argv[2]) : WIDTH;
+	int maxRank	= argc > 3 ? std::stoi(argv[3]) : 16;
+
+	struct FitConfig
+	{
+		int bands, degreeU, degreeV;
+	};
+	const FitConfig configs[] = {
+		{ 4,  3, 1 },
+		{ 8,  4, 2 },
+		{ 16, 5, 2 },
+		{ 32, 6, 3 },
+		{ 64, 8, 3 },
+	};
+
+	GLFWwindow* window = initOpenGL();
+	if (!window)
+		return -1;
+
+	// Scoped so the GL objects are deleted before the context is destroyed:
+	{
+		Shader hooblerAccumLutShader;
+		Shader hooblerSumLutShader;
+		Shader kovalovsLutShader;
+		hooblerAccumLutShader.loadShader("res/hooblerAccumLUTShader.comp");
+		hooblerSumLutShader.loadShader("res/hooblerSumLUTShader.comp");
+		kovalovsLutShader.loadShader("res/kovalovsLUTShader.comp");
+
+		TextureHandle textures[4];
+		for (int i = 0; i < 4; ++i)
+			textures[i] = GLDsa::createTexture2D(i == 3 ? GL_R32F : GL_RGBA32F, size, size, 1, GL_NEAREST, GL_NEAREST);
+		bakeHooblerLut(hooblerAccumLutShader, hooblerSumLutShader, textures[0], textures[1], textures[2], glm::ivec2(size));
+		bakeKovalovsLut(kovalovsLutShader, textures[3], glm::ivec2(size), g_gParam);
+
+		ThreadPool threadPool;
+		printf("%ix%i LUTs: Hoobler %zu bytes (RGBA32F), Kovalovs %zu bytes (R32F)\n", size, size,
+			(size_t)size * size * sizeof(glm::vec4), (size_t)size * size * sizeof(float));
+		printf("\n%-10s %6s %8s %8s %10s %10s %14s %14s %12s\n", "LUT", "Bands", "Degree u", "Degree v", "Bytes", "Fit ms", "RMSE", "Max error", "Max error %");
+
+		for (int method = 0; method < 2; ++method)
+		{
+			const bool hoobler = method == 0;
+			std::vector<float> table, fitted;
+			readLutTable(hoobler ? textures[2] : textures[3], hoobler, glm::ivec2(size), glm::ivec2(size), table);
+			const float peak = *std::max_element(table.begin(), table.end());
+
+			for (const FitConfig& config : configs)
+			{
+				LutFit fit;
+				auto start = std::chrono::steady_clock::now();
+				fit.fit(threadPool, table, size, size, config.bands, config.degreeU, config.degreeV);
+				std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+				float rmse, maxError;
+				fit.evaluateTable(size, size, fitted);
+				ScatteringReference::compare(fitted, table, rmse, maxError);
+				printf("%-10s %6i %8i %8i %10zu %10.2f %14g %14g %12.3f\n", hoobler ? "Hoobler" : "Kovalovs", config.bands,
+					config.degreeU, config.degreeV, fit.getSizeBytes(), elapsed.count(), rmse, maxError, peak > 0.0f ? maxError / peak * 100.0f : 0.0f);
+			}
+		}
+
+		printf("\n%-10s %6s %14s %10s %10s %14s %14s %12s\n", "LUT", "Rank", "Singular value", "Bytes", "Factor ms", "RMSE", "Max error", "Max error %");
+		for (int method = 0; method < 2; ++method)
+		{
+			const bool hoobler = method == 0;
+			std::vector<float> table, reconstructed;
+			readLutTable(hoobler ? textures[2] : textures[3], hoobler, glm::ivec2(size), glm::ivec2(size), table);
+			const float peak = *std::max_element(table.begin(), table.end());
+
+			// Truncating one factorisation gives every lower rank's best approximation too:
+			LowRankLut lowRank;
+			auto start = std::chrono::steady_clock::now();
+			lowRank.factor(threadPool, table, size, size, maxRank);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			for (int rank = 1; rank <= lowRank.getRank(); ++rank)
+			{
+				float rmse, maxError;
+				lowRank.reconstruct(rank, reconstructed);
+				ScatteringReference::compare(reconstructed, table, rmse, maxError);
+				printf("%-10s %6i %14g %10zu %10.2f %14g %14g %12.3f\n", hoobler ? "Hoobler" : "Kovalovs", rank, lowRank.getSingularValue(rank - 1),
+					(size_t)size * 2 * ((rank + 3) / 4) * sizeof(glm::vec4), elapsed.count(), rmse, maxError, peak > 0.0f ? maxError / peak * 100.0f : 0.0f);
+			}
+		}
+
+		// Smallest LUT each warp needs to match the max error of the unwarped LUT at 'size', all scored against
+		// ground truth as in --lut-benchmark, so Kovalovs' LUT is stretched over the furthest any point of the
+		// table's rays gets from the light and Hoobler's is stored unscaled:
+		const int TRUTH_WIDTH = 512, TRUTH_HEIGHT = 256, TRUTH_SAMPLES_PER_TEXEL = 64;
+		const int KOVALOVS_STEPS_PER_TEXEL = 16;
+		const int candidateSizes[] = { 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768 };
+		const std::vector<LutWarpConfig> warpConfigs = getLutWarpConfigs();
+		g_lightRange = 2.0f * g_vecLength + g_lightZFar;
+		g_hooblerLutScale = 1.0f;
+
+		ScatteringModel model;
+		model.gParam	= g_gParam;
+		model.constant	= g_constant;
+		model.linear	= g_linear;
+		model.quadratic	= g_quadratic;
+
+		ScatteringReference reference(threadPool);
+		std::vector<float> truth;
+		reference.bake(model, g_vecLength, g_lightZFar, TRUTH_WIDTH, TRUTH_HEIGHT, TRUTH_SAMPLES_PER_TEXEL, truth);
+		const float truthPeak = *std::max_element(truth.begin(), truth.end());
+
+		// Max error of a LUT against the truth, as a percentage of its peak:
+		auto scoreLut = [&](bool hoobler, int lutSize, const LutWarpConfig& warps)
+		{
+			g_hooblerWarps[0] = g_kovalovsWarps[0] = warps.distance;
+			g_hooblerWarps[1] = g_kovalovsWarps[1] = warps.angle;
+
+			std::vector<float> table;
+			if (hoobler)
+			{
+				TextureHandle lutTextures[3];
+				for (TextureHandle& texture : lutTextures)
+					texture = GLDsa::createTexture2D(GL_RGBA32F, lutSize, lutSize, 1, GL_NEAREST, GL_NEAREST);
+				bakeHooblerLut(hooblerAccumLutShader, hooblerSumLutShader, lutTextures[0], lutTextures[1], lutTextures[2], glm::ivec2(lutSize));
+
+				std::vector<glm::vec4> lut((size_t)lutSize * lutSize);
+				glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+				GLState::bindTexture(GL_TEXTURE_2D, lutTextures[2]);
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, lut.data());
+				reference.evaluateHooblerLut(lut, lutSize, lutSize, warps.distance, warps.angle, TRUTH_WIDTH, TRUTH_HEIGHT, table);
+			}
+			else
+			{
+				TextureHandle lutTexture = GLDsa::createTexture2D(GL_R32F, lutSize, lutSize, 1, GL_NEAREST, GL_NEAREST);
+				bakeKovalovsLut(kovalovsLutShader, lutTexture, glm::ivec2(lutSize), g_gParam);
+
+				std::vector<float> lut((size_t)lutSize * lutSize);
+				glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+				GLState::bindTexture(GL_TEXTURE_2D, lutTexture);
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, lut.data());
+				reference.evaluateKovalovsLut(lut, lutSize, lutSize, warps.distance, warps.angle, g_lightRange, g_vecLength, g_lightZFar,
+					TRUTH_WIDTH, TRUTH_HEIGHT, KOVALOVS_STEPS_PER_TEXEL, table);
+			}
+
+			float rmse, maxError;
+			ScatteringReference::compare(table, truth, rmse, maxError);
+			return truthPeak > 0.0f ? maxError / truthPeak * 100.0f : 0.0f;
+		};
+
+		// Sizes are tried smallest first, ending with 'size' itself:
+		std::vector<int> lutSizes;
+		for (int candidate : candidateSizes)
+		{
+			if (candidate < size)
+				lutSizes.push_back(candidate);
+		}
+		lutSizes.push_back(size);
+
+		printf("\nSmallest LUT matching the linear %ix%i LUT's max error against %ix%i ground truth:\n", size, size, TRUTH_WIDTH, TRUTH_HEIGHT);
+		printf("%-10s %-14s %10s %12s %10s %12s %12s\n", "LUT", "Warp", "Target %", "Resolution", "Bytes", "Max error %", "vs linear");
+		for (int method = 0; method < 2; ++method)
+		{
+			const bool hoobler = method == 0;
+			const size_t texelBytes = hoobler ? sizeof(glm::vec4) : sizeof(float);
+			const float target = scoreLut(hoobler, size, warpConfigs[0]);
+
+			int linearSize = size;
+			for (const LutWarpConfig& warps : warpConfigs)
+			{
+				int matchedSize = 0;
+				float matchedError = 0.0f;
+				for (int lutSize : lutSizes)
+				{
+					const float error = scoreLut(hoobler, lutSize, warps);
+					if (error <= target)
+					{
+						matchedSize = lutSize;
+						matchedError = error;
+						break;
+					}
+				}
+
+				// The linear warp always matches by 'size', and the rest are compared with its smallest match:
+				if (&warps == &warpConfigs[0])
+					linearSize = matchedSize;
+
+				if (matchedSize > 0)
+					printf("%-10s %-14s %10.3f %12i %10zu %12.3f %11.2fx\n", hoobler ? "Hoobler" : "Kovalovs", warps.name, target, matchedSize,
+						(size_t)matchedSize * matchedSize * texelBytes, matchedError, (double)linearSize * linearSize / ((double)matchedSize * matchedSize));
+				else
+					printf("%-10s %-14s %10.3f %12s %10s %12s %12s\n", hoobler ? "Hoobler" : "Kovalovs", warps.name, target, "-", "-", "-", "-");
+			}
+		}
+	}
+
+	glfwTerminate();
+	return 0;
+}
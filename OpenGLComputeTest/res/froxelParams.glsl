@@ -0,0 +1,31 @@
+// Per-frame scalars of the froxel passes, written once a frame into the RingBuffer and shared by the
+// light cull and the inject. Mirrors FroxelFog::GpuParams (std140), so members only go in where they
+// don't open a gap. FOG_PARAMS_BINDING comes from FroxelFog::getShaderDefines().
+layout (std140, binding = FOG_PARAMS_BINDING) uniform FogParams
+{
+    vec3    u_cameraPos;
+    float   u_aspect;
+
+    // Medium:
+    vec3    u_albedo;
+    float   u_density;
+    vec2    u_lutUvScale;       // Valid corner of the baked LUT.
+    float   u_baseHeight;
+    float   u_heightFalloff;
+    float   u_noiseAmount;
+    float   u_noiseScale;
+    float   u_gParam;
+
+    // Noise volume ring parameters (see NoiseVolume::getRingOffset()):
+    float   u_noiseRingOffset;
+    float   u_noiseDepth;
+
+    // Lights:
+    float   u_constant;
+    float   u_linear;
+    float   u_quadratic;
+    float   u_hooblerZFar;      // u_lightZFar of hooblerAccumLUTShader.comp.
+    int     u_source;
+    int     u_lightCount;
+    float   u_kovalovsRange;    // u_range of kovalovsLUTShader.comp.
+};
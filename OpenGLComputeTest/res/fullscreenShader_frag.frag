@@ -5,8 +5,62 @@ in vec2 TexCoords;
 
 // Texture samplers:
 uniform sampler2D u_lutTex;
+uniform sampler3D u_noiseTex;
+
+// 0 = 2D texture, 1 = z-slice of the noise volume:
+uniform int u_displayMode;
+uniform float u_displayLod;
+
+// Size of the rendered region of u_lutTex relative to the whole texture (see DynamicResolution), which is
+// stretched over the screen:
+uniform vec2 u_uvScale;
+
+// Statistics of the displayed texture (see TextureStats), used to stretch it over [0,1]:
+layout (std430, binding = 2) readonly buffer Stats
+{
+	vec4 minVal;
+	vec4 maxVal;
+	vec4 mean;
+};
+uniform bool u_autoNormalise;
+uniform int u_statsChannels;	// Colour channels the range is taken over: 1 for R32F LUTs, whose G and B read as 0.
+
+// Noise volume ring parameters (see NoiseVolume::getRingOffset()):
+uniform float u_noiseSliceZ;
+uniform float u_noiseRingOffset;
+uniform float u_noiseDepth;
+
+// Map a normalised depth through the noise volume to its texture coordinate in the ring of slices. Only
+// slices [floor(offset), floor(offset) + depth) are valid, so the position is clamped to keep the filter off
+// the slot being regenerated, and the slice index is wrapped before the half-texel offset is added:
+float RingSliceCoord(float w)
+{
+	const float position = min(u_noiseRingOffset + w * (u_noiseDepth - 1.0), floor(u_noiseRingOffset) + u_noiseDepth - 1.0);
+	const float slice = floor(position);
+	return (mod(slice, u_noiseDepth) + (position - slice) + 0.5) / u_noiseDepth;
+}
 
 void main()
 {
-	FragColour = texture(u_lutTex, TexCoords);
+	if (u_displayMode == 1)
+		FragColour = textureLod(u_noiseTex, vec3(TexCoords, RingSliceCoord(u_noiseSliceZ)), u_displayLod);
+	else
+	{
+		// Clamped half a texel inside the region so filtering doesn't pull in anything outside it:
+		const vec2 halfTexel = 0.5 / vec2(textureSize(u_lutTex, 0));
+		const vec2 uv = min(TexCoords * u_uvScale, u_uvScale - halfTexel);
+		FragColour = textureLod(u_lutTex, uv, u_displayLod);
+
+		if (u_autoNormalise)
+		{
+			float lo = minVal.r;
+			float hi = maxVal.r;
+			if (u_statsChannels >= 3)
+			{
+				lo = min(lo, min(minVal.g, minVal.b));
+				hi = max(hi, max(maxVal.g, maxVal.b));
+			}
+			FragColour.rgb = (FragColour.rgb - lo) / max(hi - lo, 1e-20);
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 330 core
+// Drawn by FullscreenPass::draw() with no vertex buffer: vertices 0, 1 and 2 land on (-1, -1), (3, -1) and
+// (-1, 3), a single triangle whose [-1, 1] corner covers the screen with TexCoords running over [0, 1].
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(TexCoords * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,51 @@
+// Non-uniform LUT axes, shared by the LUT bakes and everything that samples them. Each axis maps a value
+// normalised to [0, 1] to a texture coordinate with WarpEncode() and back with WarpDecode(), spending more
+// texels where the table changes fastest. Mirrors AxisWarp (LutWarp.h).
+#ifndef PI
+#define PI 3.141592653589793238462643383279
+#endif
+
+#define WARP_LINEAR 0
+#define WARP_POWER 1        // Param is the exponent, > 1 for more texels near 0.
+#define WARP_LOG 2          // Param is the steepness, > 0 for more texels near 0.
+#define WARP_PHASE_CDF 3    // Angle axes (angle / PI). Param is the g of the HG phase whose CDF spaces the texels.
+
+// Fraction of the Henyey-Greenstein phase's energy at cosines below mu:
+float PhaseCdf(float mu, float g)
+{
+    if (abs(g) < 1e-3)
+        return 0.5 * (mu + 1.0);
+    return (1.0 - g * g) / (2.0 * g) * (1.0 / sqrt(1.0 + g * g - 2.0 * g * mu) - 1.0 / (1.0 + g));
+}
+
+float PhaseInverseCdf(float xi, float g)
+{
+    if (abs(g) < 1e-3)
+        return 2.0 * xi - 1.0;
+    float s = (1.0 - g * g) / (1.0 - g + 2.0 * g * xi);
+    return (1.0 + g * g - s * s) / (2.0 * g);
+}
+
+float WarpEncode(float x, int warp, float param)
+{
+    x = clamp(x, 0.0, 1.0);
+    if (warp == WARP_POWER)
+        return pow(x, 1.0 / param);
+    if (warp == WARP_LOG)
+        return log(1.0 + x * (exp(param) - 1.0)) / param;
+    if (warp == WARP_PHASE_CDF)
+        return 1.0 - PhaseCdf(cos(x * PI), param);    // Forward scattering (angle 0) at 0.
+    return x;
+}
+
+float WarpDecode(float u, int warp, float param)
+{
+    u = clamp(u, 0.0, 1.0);
+    if (warp == WARP_POWER)
+        return pow(u, param);
+    if (warp == WARP_LOG)
+        return (exp(param * u) - 1.0) / (exp(param) - 1.0);
+    if (warp == WARP_PHASE_CDF)
+        return acos(clamp(PhaseInverseCdf(1.0 - u, param), -1.0, 1.0)) / PI;
+    return u;
+}